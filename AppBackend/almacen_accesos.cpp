@@ -0,0 +1,306 @@
+#include "almacen_accesos.h"
+#include "registro_zonas.h"
+#include <algorithm>
+#include <climits>
+
+IteradorAccesos::IteradorAccesos(const AlmacenAccesos *a, size_t p, IteradorTiempo i)
+    : almacen(a), particion(p), it(i), actual{0, 0, 0}
+{
+    ajustar();
+}
+
+void IteradorAccesos::ajustar()
+{
+    while (!it.valido())
+    {
+        if (particion >= almacen->particiones.size() || ++particion == almacen->particiones.size())
+        {
+            almacen = nullptr;
+            return;
+        }
+        it = almacen->particiones[particion]->desde(LONG_MIN, -1);
+    }
+    actual = *it;
+}
+
+IteradorAccesos &IteradorAccesos::operator++()
+{
+    ++it;
+    ajustar();
+    return *this;
+}
+
+AlmacenAccesos::AlmacenAccesos(long duracion_particion, long retencion_seg)
+    : duracion(duracion_particion), retencion(retencion_seg), maxTimestamp(LONG_MIN), base(0), cantidad(0)
+{
+}
+
+AlmacenAccesos::~AlmacenAccesos()
+{
+    for (IndiceTiempo *p : particiones)
+        delete p;
+}
+
+// Redondea hacia abajo también para timestamps negativos. Cerca de LONG_MIN
+// (búsquedas "desde el principio") devuelve LONG_MIN, antes de toda partición
+long AlmacenAccesos::inicioParticion(long ts) const
+{
+    if (ts < LONG_MIN + duracion)
+        return LONG_MIN;
+    long resto = ts % duracion;
+    if (resto < 0)
+        resto += duracion;
+    return ts - resto;
+}
+
+bool AlmacenAccesos::vencida(long inicio) const
+{
+    return retencion > 0 && maxTimestamp != LONG_MIN && inicio + duracion <= maxTimestamp - retencion;
+}
+
+void AlmacenAccesos::sumarCantidad(size_t pos, long delta)
+{
+    for (size_t i = base + pos + 1; i < acumulado.size(); i += i & (~i + 1))
+        acumulado[i] += delta;
+}
+
+long AlmacenAccesos::prefijo(size_t celda) const
+{
+    long suma = 0;
+    for (size_t i = celda; i > 0; i -= i & (~i + 1))
+        suma += acumulado[i];
+    return suma;
+}
+
+// Las celdas de antes de base están en 0, así que el prefijo absoluto es
+// también el de las particiones retenidas
+long AlmacenAccesos::cantidadAntes(size_t pos) const
+{
+    return prefijo(base + pos);
+}
+
+// Cada celda suma su propia partición y la pasa a la celda que la cubre
+void AlmacenAccesos::reconstruirAcumulado()
+{
+    size_t n = particiones.size();
+    base = 0;
+    acumulado.assign(n + 1, 0);
+    for (size_t i = 1; i <= n; ++i)
+    {
+        acumulado[i] += particiones[i - 1]->getCantidad();
+        size_t j = i + (i & (~i + 1));
+        if (j <= n)
+            acumulado[j] += acumulado[i];
+    }
+}
+
+// La celda nueva i cubre las celdas (i - lsb(i), i]; como la nueva todavía
+// está vacía, su valor sale de dos prefijos (absolutos, sin base)
+size_t AlmacenAccesos::particionPara(long inicio)
+{
+    if (!inicios.empty() && inicio == inicios.back())
+        return inicios.size() - 1;
+    if (inicios.empty() || inicio > inicios.back())
+    {
+        inicios.push_back(inicio);
+        particiones.push_back(new IndiceTiempo(&nodosRezagados));
+        size_t i = acumulado.empty() ? 1 : acumulado.size();
+        if (acumulado.empty())
+            acumulado.push_back(0);
+        acumulado.push_back(prefijo(i - 1) - prefijo(i - (i & (~i + 1))));
+        return particiones.size() - 1;
+    }
+    size_t pos = std::lower_bound(inicios.begin(), inicios.end(), inicio) - inicios.begin();
+    if (inicios[pos] != inicio)
+    {
+        inicios.insert(inicios.begin() + pos, inicio);
+        particiones.insert(particiones.begin() + pos, new IndiceTiempo(&nodosRezagados));
+        reconstruirAcumulado();
+    }
+    return pos;
+}
+
+// Una partición vencida se descarta entera: se restan sus conteos por zona
+// (uno por zona, no por acceso), su celda del Fenwick queda en 0 y se libera
+// su índice. Las demás no se mueven: base avanza una celda
+void AlmacenAccesos::descartarVencidas()
+{
+    while (!particiones.empty() && vencida(inicios.front()))
+    {
+        IndiceTiempo *p = particiones.front();
+        for (int z = 0; z < p->getCantidadZonas(); ++z)
+            conteoZonas.incrementar(p->zonaGlobalDe(z), -p->conteoZonaLocal(z));
+        cantidad -= p->getCantidad();
+        sumarCantidad(0, -p->getCantidad());
+        delete p;
+        inicios.pop_front();
+        particiones.pop_front();
+        ++base;
+    }
+    // Con más celdas muertas que vivas se compacta: O(P) cada P descartes
+    if (base > particiones.size())
+        reconstruirAcumulado();
+}
+
+bool AlmacenAccesos::insertar(const std::string &zona, long ts)
+{
+    if (!admite(ts))
+        return false;
+    int zonaId = RegistroZonas::global().registrar(zona);
+    if (zonaId < 0)
+        return false;
+    insertarAdmitido(zonaId, ts);
+    return true;
+}
+
+bool AlmacenAccesos::insertar(int zonaId, long ts)
+{
+    if (!admite(ts))
+        return false;
+    insertarAdmitido(zonaId, ts);
+    return true;
+}
+
+void AlmacenAccesos::insertarAdmitido(int zonaId, long ts)
+{
+    size_t pos = particionPara(inicioParticion(ts));
+    particiones[pos]->insertar(zonaId, ts);
+    sumarCantidad(pos, 1);
+    conteoZonas.incrementar(zonaId);
+    ++cantidad;
+    if (ts > maxTimestamp)
+    {
+        maxTimestamp = ts;
+        descartarVencidas();
+    }
+}
+
+IteradorAccesos AlmacenAccesos::desde(long ts, long seq) const
+{
+    long inicio = inicioParticion(ts);
+    size_t pos = std::lower_bound(inicios.begin(), inicios.end(), inicio) - inicios.begin();
+    if (pos == particiones.size())
+        return IteradorAccesos(this, pos, IteradorTiempo());
+    if (inicios[pos] == inicio)
+        return IteradorAccesos(this, pos, particiones[pos]->desde(ts, seq));
+    return IteradorAccesos(this, pos, particiones[pos]->desde(LONG_MIN, -1));
+}
+
+bool AlmacenAccesos::rangoPagina(long desdeTs, long desdeSeq, long fin, int limite,
+                                 std::vector<Acceso> &out) const
+{
+    out.clear();
+    IteradorAccesos it = desde(desdeTs, desdeSeq);
+    for (; it.valido() && it->timestamp <= fin && static_cast<int>(out.size()) < limite; ++it)
+        out.push_back(*it);
+    return it.valido() && it->timestamp <= fin;
+}
+
+// Las particiones anteriores salen del Fenwick; solo la del borde busca adentro
+long AlmacenAccesos::contarHasta(long ts, long seq) const
+{
+    long inicio = inicioParticion(ts);
+    size_t pos = std::lower_bound(inicios.begin(), inicios.end(), inicio) - inicios.begin();
+    long cuenta = cantidadAntes(pos);
+    if (pos < particiones.size() && inicios[pos] == inicio)
+        cuenta += particiones[pos]->contarHasta(ts, seq);
+    return cuenta;
+}
+
+long AlmacenAccesos::contarRango(long inicio, long fin) const
+{
+    if (inicio > fin)
+        return 0;
+    return contarHasta(fin, LONG_MAX) - contarHasta(inicio, -1);
+}
+
+size_t AlmacenAccesos::getMemoria() const
+{
+    size_t bytes = 0;
+    for (const IndiceTiempo *p : particiones)
+        bytes += p->getMemoria();
+    return bytes;
+}
+
+// Bajada por el Fenwick: avanza mientras el bloque siguiente termina antes
+// del k-ésimo, y queda en la partición que lo contiene. Las celdas
+// descartadas suman 0, así que nunca se queda en una de ellas
+bool AlmacenAccesos::seleccionar(long k, Acceso &out) const
+{
+    if (k < 0 || k >= cantidad)
+        return false;
+    size_t n = acumulado.size() - 1;
+    size_t paso = 1;
+    while (paso * 2 <= n)
+        paso *= 2;
+    size_t pos = 0;
+    for (; paso > 0; paso /= 2)
+    {
+        if (pos + paso <= n && acumulado[pos + paso] <= k)
+        {
+            pos += paso;
+            k -= acumulado[pos];
+        }
+    }
+    return particiones[pos - base]->seleccionar(k, out);
+}
+
+std::vector<long> AlmacenAccesos::conteoZonasEnRango(long inicio, long fin) const
+{
+    std::vector<long> acum(conteoZonas.getCantidad(), 0);
+    size_t pos = std::lower_bound(inicios.begin(), inicios.end(), inicioParticion(inicio)) - inicios.begin();
+    for (; pos < particiones.size() && inicios[pos] <= fin; ++pos)
+    {
+        const IndiceTiempo *par = particiones[pos];
+        if (inicios[pos] >= inicio && inicios[pos] + duracion - 1 <= fin)
+        {
+            for (int z = 0; z < par->getCantidadZonas(); ++z)
+                acum[par->zonaGlobalDe(z)] += par->conteoZonaLocal(z);
+            continue;
+        }
+        std::vector<long> local = par->conteoZonasLocalesEnRango(inicio, fin);
+        for (size_t z = 0; z < local.size(); ++z)
+            acum[par->zonaGlobalDe(static_cast<int>(z))] += local[z];
+    }
+    return acum;
+}
+
+std::string AlmacenAccesos::zonaMasEntradas(long inicio, long fin) const
+{
+    std::vector<long> conteo = conteoZonasEnRango(inicio, fin);
+    int mejor = -1;
+    for (int z = 0; z < static_cast<int>(conteo.size()); ++z)
+    {
+        if (conteo[z] > 0 && (mejor < 0 || conteo[z] > conteo[mejor]))
+            mejor = z;
+    }
+    return mejor < 0 ? std::string() : nombreZona(mejor);
+}
+
+// Las zonas de particiones descartadas quedan registradas con conteo 0
+std::string AlmacenAccesos::zonaMasEntradas() const
+{
+    int mejor = conteoZonas.idMaximo();
+    return (mejor < 0 || conteoZonas.getConteo(mejor) == 0) ? std::string() : nombreZona(mejor);
+}
+
+const std::string &AlmacenAccesos::nombreZona(int zonaId) const
+{
+    return RegistroZonas::global().nombre(zonaId);
+}
+
+std::vector<std::pair<std::string, long>> AlmacenAccesos::zonasTop(int k) const
+{
+    std::vector<std::pair<std::string, long>> out;
+    int n = conteoZonas.getCantidad();
+    if (k > n)
+        k = n;
+    for (int i = 0; i < k; ++i)
+    {
+        int id = conteoZonas.idEnPosicion(i);
+        if (conteoZonas.getConteo(id) == 0)
+            break;
+        out.push_back({nombreZona(id), conteoZonas.getConteo(id)});
+    }
+    return out;
+}
@@ -1,41 +1,151 @@
 #include "avl_tree.h"
+#include "registro_zonas.h"
+#include <climits>
 #include <iostream>
+#include <utility>
+
+void ConteoZonasNodo::agrandar(int n)
+{
+    if (n <= tam)
+        return;
+    for (int z = tam; z < n && z < ZONAS_EN_LINEA; ++z)
+        enLinea[z] = 0;
+    if (n > ZONAS_EN_LINEA)
+    {
+        int viejos = tam > ZONAS_EN_LINEA ? tam - ZONAS_EN_LINEA : 0;
+        int *nuevo = new int[n - ZONAS_EN_LINEA]();
+        for (int i = 0; i < viejos; ++i)
+            nuevo[i] = resto[i];
+        delete[] resto;
+        resto = nuevo;
+    }
+    tam = n;
+}
+
+void ConteoZonasNodo::limpiar()
+{
+    for (int z = 0; z < tam; ++z)
+        (*this)[z] = 0;
+}
+
+void ConteoZonasNodo::swap(ConteoZonasNodo &otro)
+{
+    std::swap(enLinea, otro.enLinea);
+    std::swap(tam, otro.tam);
+    std::swap(resto, otro.resto);
+}
 
 // Constructor
-ArbolAVL::ArbolAVL() : raiz(nullptr) {}
+ArbolAVL::ArbolAVL(PoolNodos<NodoAVL> *pool)
+    : raiz(nullptr), nodos(pool), poolPropio(nullptr), siguienteSecuencia(0)
+{
+    if (!nodos)
+        nodos = poolPropio = new PoolNodos<NodoAVL>;
+}
+
+ArbolAVL::~ArbolAVL()
+{
+    liberarRec(raiz);
+    delete poolPropio;
+}
+
+void ArbolAVL::vaciar()
+{
+    liberarRec(raiz);
+    raiz = nullptr;
+    siguienteSecuencia = 0;
+    conteoZonas = RankingConteo();
+}
+
+void ArbolAVL::liberarRec(NodoAVL *nodo)
+{
+    if (!nodo)
+        return;
+    liberarRec(nodo->izquierdo);
+    liberarRec(nodo->derecho);
+    nodos->destruir(nodo);
+}
 
 // Insercion
 void ArbolAVL::insertar(const std::string &zona, long ts)
 {
-    raiz = insertarRecursivo(raiz, zona, ts);
+    int zonaId = RegistroZonas::global().registrar(zona);
+    if (zonaId >= 0)
+        insertar(zonaId, ts, siguienteSecuencia);
 }
 
-// Insercion recursiva con rebalanceo
-NodoAVL *ArbolAVL::insertarRecursivo(NodoAVL *nodo, const std::string &zona, long ts)
+void ArbolAVL::insertar(int zonaId, long ts)
+{
+    insertar(zonaId, ts, siguienteSecuencia);
+}
+
+void ArbolAVL::insertar(int zonaId, long ts, long seq)
+{
+    siguienteSecuencia = seq + 1;
+    raiz = insertarRecursivo(raiz, zonaId, ts, seq);
+    conteoZonas.incrementar(zonaId);
+}
+
+// Insercion recursiva con rebalanceo. Un timestamp repetido va a la derecha
+// y su secuencia es la mayor hasta ahora, así que el árbol queda ordenado
+// por (timestamp, secuencia) sin comparar la secuencia. Cada nodo del
+// camino gana un acceso de esa zona en su subárbol
+NodoAVL *ArbolAVL::insertarRecursivo(NodoAVL *nodo, int zonaId, long ts, long seq)
 {
     if (!nodo)
-        return new NodoAVL(zona, ts);
+    {
+        NodoAVL *nuevo = nodos->crear(zonaId, ts, seq);
+        sumarZona(nuevo, zonaId);
+        return nuevo;
+    }
+    sumarZona(nodo, zonaId);
     if (ts < nodo->timestamp)
     {
-        nodo->izquierdo = insertarRecursivo(nodo->izquierdo, zona, ts);
+        nodo->izquierdo = insertarRecursivo(nodo->izquierdo, zonaId, ts, seq);
         nodo->izquierdo->padre = nodo;
     }
     else
     {
-        nodo->derecho = insertarRecursivo(nodo->derecho, zona, ts);
+        nodo->derecho = insertarRecursivo(nodo->derecho, zonaId, ts, seq);
         nodo->derecho->padre = nodo;
     }
     actualizarFactor(nodo);
     return reBalancear(nodo);
 }
 
-// actualizar altura
+// actualizar altura y tamaño. Las rotaciones lo llaman para los dos nodos
+// que cambian de hijos, de abajo hacia arriba
 void ArbolAVL::actualizarFactor(NodoAVL *nodo)
 {
     int h_izq = nodo->izquierdo ? nodo->izquierdo->altura : 0;
     int h_der = nodo->derecho ? nodo->derecho->altura : 0;
     nodo->altura = 1 + (h_izq > h_der ? h_izq : h_der);
     nodo->factor_balance = h_izq - h_der;
+    nodo->tamano = 1 + (nodo->izquierdo ? nodo->izquierdo->tamano : 0) +
+                   (nodo->derecho ? nodo->derecho->tamano : 0);
+}
+
+void ArbolAVL::sumarZona(NodoAVL *nodo, int zonaId)
+{
+    if (zonaId >= nodo->conteoZonasSub.size())
+        nodo->conteoZonasSub.agrandar(zonaId + 1);
+    ++nodo->conteoZonasSub[zonaId];
+}
+
+void ArbolAVL::actualizarZonas(NodoAVL *nodo)
+{
+    ConteoZonasNodo &c = nodo->conteoZonasSub;
+    c.limpiar();
+    for (NodoAVL *hijo : {nodo->izquierdo, nodo->derecho})
+    {
+        if (!hijo)
+            continue;
+        const ConteoZonasNodo &h = hijo->conteoZonasSub;
+        c.agrandar(h.size());
+        for (int z = 0; z < h.size(); ++z)
+            c[z] += h[z];
+    }
+    sumarZona(nodo, nodo->zonaId);
 }
 
 // Rebalanceo segun factor
@@ -68,6 +178,10 @@ NodoAVL *ArbolAVL::rotarIzquierda(NodoAVL *nodo)
     nodo->padre = r;
     actualizarFactor(nodo);
     actualizarFactor(r);
+    // r pasa a cubrir el subárbol que antes cubría nodo: hereda sus
+    // conteos, y solo nodo se recalcula
+    r->conteoZonasSub.swap(nodo->conteoZonasSub);
+    actualizarZonas(nodo);
     return r;
 }
 
@@ -82,6 +196,8 @@ NodoAVL *ArbolAVL::rotarDerecha(NodoAVL *nodo)
     nodo->padre = l;
     actualizarFactor(nodo);
     actualizarFactor(l);
+    l->conteoZonasSub.swap(nodo->conteoZonasSub);
+    actualizarZonas(nodo);
     return l;
 }
 
@@ -103,7 +219,7 @@ void ArbolAVL::mostrarRecursivo(NodoAVL *nodo, int nivel)
     mostrarRecursivo(nodo->derecho, nivel + 1);
     for (int i = 0; i < nivel; ++i)
         std::cout << "    ";
-    std::cout << nodo->zona << " @" << nodo->timestamp
+    std::cout << nombreZona(nodo->zonaId) << " @" << nodo->timestamp
               << " (" << nodo->factor_balance << ")\n";
     mostrarRecursivo(nodo->izquierdo, nivel + 1);
 }
@@ -116,47 +232,194 @@ std::vector<NodoAVL *> ArbolAVL::rangoTiempos(long inicio, long fin)
     return out;
 }
 
-// Recursion para obtener nodos en rango
+// Recursion para obtener nodos en rango. Las rotaciones pueden dejar
+// timestamps iguales a ambos lados, por eso se baja también con igualdad
 void ArbolAVL::rangoRec(NodoAVL *nodo, long inicio, long fin, std::vector<NodoAVL *> &out)
 {
     if (!nodo)
         return;
-    if (nodo->timestamp > inicio)
+    if (nodo->timestamp >= inicio)
         rangoRec(nodo->izquierdo, inicio, fin, out);
     if (nodo->timestamp >= inicio && nodo->timestamp <= fin)
         out.push_back(nodo);
-    if (nodo->timestamp < fin)
+    if (nodo->timestamp <= fin)
         rangoRec(nodo->derecho, inicio, fin, out);
 }
 
-// Zona con mas entradas (usa TablaHash para conteo)
-std::string ArbolAVL::zonaMasEntradas()
+IteradorAVL &IteradorAVL::operator++()
+{
+    if (actual->derecho)
+    {
+        // El menor del subárbol derecho
+        actual = actual->derecho;
+        while (actual->izquierdo)
+            actual = actual->izquierdo;
+        return *this;
+    }
+    // Subir hasta llegar desde un hijo izquierdo
+    NodoAVL *hijo = actual;
+    actual = actual->padre;
+    while (actual && hijo == actual->derecho)
+    {
+        hijo = actual;
+        actual = actual->padre;
+    }
+    return *this;
+}
+
+// Cota inferior exclusiva: se recuerda el último nodo mayor que la clave
+// al bajar por la izquierda
+IteradorAVL ArbolAVL::desde(long ts, long seq) const
 {
-    TablaHash cnt(101, 0.7f);
-    contarZonas(raiz, cnt);
-    std::string best;
-    int maxc = 0;
-    for (int i = 0; i < cnt.getTam(); ++i)
+    NodoAVL *candidato = nullptr;
+    NodoAVL *n = raiz;
+    while (n)
     {
-        NodoHash *n = cnt.getBucket(i);
-        while (n)
+        if (n->timestamp > ts || (n->timestamp == ts && n->secuencia > seq))
         {
-            if (n->contador > maxc)
+            candidato = n;
+            n = n->izquierdo;
+        }
+        else
+            n = n->derecho;
+    }
+    return IteradorAVL(candidato);
+}
+
+bool ArbolAVL::rangoPagina(long desdeTs, long desdeSeq, long fin, int limite,
+                           std::vector<NodoAVL *> &out)
+{
+    out.clear();
+    IteradorAVL it = desde(desdeTs, desdeSeq);
+    for (; it.valido() && it->timestamp <= fin && static_cast<int>(out.size()) < limite; ++it)
+        out.push_back(*it);
+    return it.valido() && it->timestamp <= fin;
+}
+
+// Al bajar a la derecha se cuentan el nodo y todo su subárbol izquierdo
+long ArbolAVL::contarHasta(long ts, long seq) const
+{
+    long cuenta = 0;
+    NodoAVL *n = raiz;
+    while (n)
+    {
+        if (n->timestamp < ts || (n->timestamp == ts && n->secuencia <= seq))
+        {
+            cuenta += 1 + (n->izquierdo ? n->izquierdo->tamano : 0);
+            n = n->derecho;
+        }
+        else
+            n = n->izquierdo;
+    }
+    return cuenta;
+}
+
+// Las secuencias son >= 0: (inicio, -1) queda antes de todo acceso con
+// timestamp inicio, y (fin, LONG_MAX) después de todos los de fin
+long ArbolAVL::contarRango(long inicio, long fin) const
+{
+    if (inicio > fin)
+        return 0;
+    return contarHasta(fin, LONG_MAX) - contarHasta(inicio, -1);
+}
+
+NodoAVL *ArbolAVL::seleccionar(long k) const
+{
+    NodoAVL *n = raiz;
+    while (n)
+    {
+        long izq = n->izquierdo ? n->izquierdo->tamano : 0;
+        if (k < izq)
+            n = n->izquierdo;
+        else if (k == izq)
+            return n;
+        else
+        {
+            k -= izq + 1;
+            n = n->derecho;
+        }
+    }
+    return nullptr;
+}
+
+// Como contarHasta, pero sumando los conteos por zona del subárbol
+// izquierdo y la zona del nodo cada vez que se baja a la derecha
+void ArbolAVL::contarZonasHasta(long ts, long seq, std::vector<long> &acum, long signo) const
+{
+    NodoAVL *n = raiz;
+    while (n)
+    {
+        if (n->timestamp < ts || (n->timestamp == ts && n->secuencia <= seq))
+        {
+            if (n->izquierdo)
             {
-                maxc = n->contador;
-                best = n->perfil;
+                const ConteoZonasNodo &h = n->izquierdo->conteoZonasSub;
+                for (int z = 0; z < h.size(); ++z)
+                    acum[z] += signo * h[z];
             }
-            n = n->siguiente;
+            acum[n->zonaId] += signo;
+            n = n->derecho;
         }
+        else
+            n = n->izquierdo;
     }
-    return best;
 }
 
-void ArbolAVL::contarZonas(NodoAVL *nodo, TablaHash &cnt)
+std::vector<long> ArbolAVL::conteoZonasEnRango(long inicio, long fin) const
 {
-    if (!nodo)
-        return;
-    cnt.incrementar(nodo->zona);
-    contarZonas(nodo->izquierdo, cnt);
-    contarZonas(nodo->derecho, cnt);
+    std::vector<long> acum(conteoZonas.getCantidad(), 0);
+    if (inicio > fin)
+        return acum;
+    contarZonasHasta(fin, LONG_MAX, acum, 1);
+    contarZonasHasta(inicio, -1, acum, -1);
+    return acum;
+}
+
+std::string ArbolAVL::zonaMasEntradas(long inicio, long fin) const
+{
+    std::vector<long> conteo = conteoZonasEnRango(inicio, fin);
+    int mejor = -1;
+    for (int z = 0; z < static_cast<int>(conteo.size()); ++z)
+    {
+        if (conteo[z] > 0 && (mejor < 0 || conteo[z] > conteo[mejor]))
+            mejor = z;
+    }
+    return mejor < 0 ? std::string() : nombreZona(mejor);
+}
+
+const std::string &ArbolAVL::nombreZona(int zonaId) const
+{
+    return RegistroZonas::global().nombre(zonaId);
+}
+
+size_t ArbolAVL::getMemoria() const
+{
+    size_t bytes = 0;
+    for (IteradorAVL it = desde(LONG_MIN, -1); it.valido(); ++it)
+        bytes += sizeof(NodoAVL) + it->conteoZonasSub.bytesAparte();
+    return bytes;
+}
+
+// Zona con mas entradas: el conteo se mantiene al insertar, no se recorre el arbol
+std::string ArbolAVL::zonaMasEntradas()
+{
+    int mejor = conteoZonas.idMaximo();
+    return (mejor < 0 || conteoZonas.getConteo(mejor) == 0) ? std::string() : nombreZona(mejor);
+}
+
+std::vector<std::pair<std::string, long>> ArbolAVL::zonasTop(int k)
+{
+    std::vector<std::pair<std::string, long>> out;
+    int n = conteoZonas.getCantidad();
+    if (k > n)
+        k = n;
+    for (int i = 0; i < k; ++i)
+    {
+        int id = conteoZonas.idEnPosicion(i);
+        // Ids de zonas que solo se registraron en otro índice
+        if (conteoZonas.getConteo(id) == 0)
+            break;
+        out.push_back({nombreZona(id), conteoZonas.getConteo(id)});
+    }
+    return out;
 }
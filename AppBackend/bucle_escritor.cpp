@@ -0,0 +1,166 @@
+#include "bucle_escritor.h"
+#include <chrono>
+
+ColaMPSC::ColaMPSC()
+    : cabeza(&centinela), cola(&centinela)
+{
+    centinela.siguiente.store(nullptr, std::memory_order_relaxed);
+}
+
+void ColaMPSC::encolar(Comando *c)
+{
+    c->siguiente.store(nullptr, std::memory_order_relaxed);
+    // seq_cst: se empareja con la lectura de "durmiendo" en BucleEscritor
+    Comando *anterior = cabeza.exchange(c);
+    anterior->siguiente.store(c, std::memory_order_release);
+}
+
+Comando *ColaMPSC::desencolar()
+{
+    Comando *actual = cola;
+    Comando *sig = actual->siguiente.load(std::memory_order_acquire);
+    if (actual == &centinela)
+    {
+        if (!sig)
+            return nullptr;
+        cola = sig;
+        actual = sig;
+        sig = sig->siguiente.load(std::memory_order_acquire);
+    }
+    if (sig)
+    {
+        cola = sig;
+        return actual;
+    }
+    // actual es el último: si un productor ya lo reemplazó en la cabeza
+    // pero todavía no enlazó el siguiente, hay que esperar a la próxima vuelta
+    if (actual != cabeza.load(std::memory_order_acquire))
+        return nullptr;
+    // Se reencola el centinela para poder soltar al último comando
+    encolar(&centinela);
+    sig = actual->siguiente.load(std::memory_order_acquire);
+    if (sig)
+    {
+        cola = sig;
+        return actual;
+    }
+    return nullptr;
+}
+
+// "cola" apunta al próximo comando a devolver o al centinela: solo está
+// vacía si además ningún productor reemplazó la cabeza
+bool ColaMPSC::vacia() const
+{
+    return cola == &centinela && cabeza.load() == &centinela;
+}
+
+BucleEscritor::BucleEscritor()
+    : activo(false), durmiendo(false)
+{
+}
+
+BucleEscritor::~BucleEscritor()
+{
+    detener();
+}
+
+void BucleEscritor::iniciar(std::function<void()> alTerminarLoteFn)
+{
+    alTerminarLote = alTerminarLoteFn;
+    {
+        std::unique_lock<std::shared_mutex> lk(mutexVista);
+        if (alTerminarLote)
+            alTerminarLote();
+    }
+    activo.store(true);
+    hilo = std::thread(&BucleEscritor::bucle, this);
+}
+
+void BucleEscritor::detener()
+{
+    if (!activo.exchange(false))
+        return;
+    {
+        std::lock_guard<std::mutex> lk(mutexDormir);
+        despertar.notify_one();
+    }
+    hilo.join();
+}
+
+void BucleEscritor::encolar(Comando *c)
+{
+    pendientes.encolar(c);
+    // Solo se toca el mutex si el escritor está (o va a estar) dormido
+    if (durmiendo.load())
+    {
+        std::lock_guard<std::mutex> lk(mutexDormir);
+        despertar.notify_one();
+    }
+}
+
+int BucleEscritor::aplicarLote()
+{
+    Comando *lote[LOTE_MAXIMO];
+    int n = 0;
+    while (n < LOTE_MAXIMO)
+    {
+        Comando *c = pendientes.desencolar();
+        if (!c)
+            break;
+        lote[n++] = c;
+    }
+    if (n == 0)
+        return 0;
+
+    {
+        std::unique_lock<std::shared_mutex> lk(mutexVista);
+        for (int i = 0; i < n; ++i)
+        {
+            try
+            {
+                lote[i]->ejecutar(lote[i]->contexto);
+            }
+            catch (...)
+            {
+                lote[i]->error = std::current_exception();
+            }
+        }
+        if (alTerminarLote)
+            alTerminarLote();
+    }
+
+    // Recién ahora se despierta a los handlers: ya ven el lote publicado.
+    // Se avisa con el mutex del comando tomado, así el handler no puede
+    // volver (y destruir su pila) hasta soltarlo; después no se lo toca más
+    for (int i = 0; i < n; ++i)
+    {
+        std::lock_guard<std::mutex> lk(lote[i]->mutexFin);
+        lote[i]->terminado = true;
+        lote[i]->fin.notify_one();
+    }
+    return n;
+}
+
+void BucleEscritor::bucle()
+{
+    while (activo.load())
+    {
+        if (aplicarLote() > 0)
+            continue;
+        if (!pendientes.vacia())
+        {
+            // Un productor está a mitad de encolar
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(mutexDormir);
+        durmiendo.store(true);
+        if (pendientes.vacia() && activo.load())
+            despertar.wait_for(lk, std::chrono::milliseconds(50));
+        durmiendo.store(false);
+    }
+    // Vacía lo que haya quedado para no dejar handlers esperando
+    while (aplicarLote() > 0)
+    {
+    }
+}
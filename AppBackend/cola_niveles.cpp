@@ -0,0 +1,251 @@
+#include "cola_niveles.h"
+
+ColaPorNiveles::ColaPorNiveles(int cap_inicial)
+    : mascara(0), tamanio(0), siguienteSeq(0), numLibres(0), capFichas(0)
+{
+    fichas = nullptr;
+    libres = nullptr;
+    int cap = 16;
+    while (cap < cap_inicial)
+        cap *= 2;
+    for (int p = 0; p < NIVELES; ++p)
+    {
+        niveles[p].datos = new Entrada[cap];
+        niveles[p].capacidad = cap;
+        niveles[p].inicio = 0;
+        niveles[p].cantidad = 0;
+        niveles[p].vivos = 0;
+    }
+}
+
+ColaPorNiveles::~ColaPorNiveles()
+{
+    for (int p = 0; p < NIVELES; ++p)
+        delete[] niveles[p].datos;
+    delete[] fichas;
+    delete[] libres;
+}
+
+// Misma tabla perfil→prioridad que MaxHeap
+int ColaPorNiveles::perfilAPrioridad(const std::string &perfil) const
+{
+    if (perfil == "vip")
+        return 5;
+    if (perfil == "personal-medico")
+        return 4;
+    if (perfil == "seguridad")
+        return 3;
+    if (perfil == "discapacitados")
+        return 2;
+    if (perfil == "publico-general")
+        return 1;
+    return 0; // desconocido o perfil inválido
+}
+
+// Corre las vigentes hacia el frente, en el mismo arreglo y en orden
+void ColaPorNiveles::compactar(Anillo &a)
+{
+    int c = 0;
+    for (int i = 0; i < a.cantidad; ++i)
+    {
+        if (vigente(en(a, i)))
+            en(a, c++) = en(a, i);
+    }
+    a.cantidad = c;
+}
+
+// Anillo lleno: si las vigentes ocupan hasta la mitad, alcanza con quitar
+// las descartadas; si no, se copian a uno del doble que queda comenzando en 0
+void ColaPorNiveles::expandir(Anillo &a)
+{
+    if (a.vivos * 2 <= a.capacidad)
+    {
+        compactar(a);
+        return;
+    }
+    Entrada *nuevo = new Entrada[a.capacidad * 2];
+    int c = 0;
+    for (int i = 0; i < a.cantidad; ++i)
+    {
+        if (vigente(en(a, i)))
+            nuevo[c++] = en(a, i);
+    }
+    delete[] a.datos;
+    a.datos = nuevo;
+    a.capacidad *= 2;
+    a.inicio = 0;
+    a.cantidad = c;
+}
+
+// Agrega al final del nivel. Si llega con un ts anterior al último, busca su
+// lugar (después de los de igual ts) y corre hacia afuera el lado más corto
+// del anillo; con llegadas en orden no se mueve nada (O(1))
+void ColaPorNiveles::encolar(long dni, int prioridad, long ts)
+{
+    if (prioridad < 0)
+        prioridad = 0;
+    if (prioridad >= NIVELES)
+        prioridad = NIVELES - 1;
+    Anillo &a = niveles[prioridad];
+    if (a.cantidad == a.capacidad)
+        expandir(a);
+
+    Entrada e;
+    e.dni = dni;
+    e.ts = ts;
+    e.seq = siguienteSeq++;
+    int pos = a.cantidad;
+    if (pos > 0 && en(a, pos - 1).ts > ts)
+    {
+        int lo = 0;
+        while (lo < pos)
+        {
+            int mid = lo + (pos - lo) / 2;
+            if (en(a, mid).ts > ts)
+                pos = mid;
+            else
+                lo = mid + 1;
+        }
+    }
+    if (a.cantidad - pos <= pos)
+    {
+        for (int i = a.cantidad; i > pos; --i)
+            en(a, i) = en(a, i - 1);
+    }
+    else
+    {
+        a.inicio = (a.inicio - 1) & (a.capacidad - 1);
+        for (int i = 0; i < pos; ++i)
+            en(a, i) = en(a, i + 1);
+    }
+    en(a, pos) = e;
+    ++a.cantidad;
+    ++a.vivos;
+    mascara |= 1u << prioridad;
+
+    // Ficha del DNI: se reutiliza una libre o se agranda el arreglo
+    if (numLibres == 0)
+    {
+        int nuevaCap = capFichas ? capFichas * 2 : 16;
+        Ficha *nuevas = new Ficha[nuevaCap];
+        int *nuevosLibres = new int[nuevaCap];
+        for (int j = 0; j < capFichas; ++j)
+            nuevas[j] = fichas[j];
+        for (int j = nuevaCap - 1; j >= capFichas; --j)
+            nuevosLibres[numLibres++] = j;
+        delete[] fichas;
+        delete[] libres;
+        fichas = nuevas;
+        libres = nuevosLibres;
+        capFichas = nuevaCap;
+    }
+    int f = libres[--numLibres];
+    fichas[f].seq = e.seq;
+    fichas[f].prioridad = prioridad;
+    fichas[f].ts = ts;
+    vigentes.asignar(dni, f);
+    ++tamanio;
+}
+
+void ColaPorNiveles::descartar(long dni, int ficha)
+{
+    int prioridad = fichas[ficha].prioridad;
+    vigentes.eliminar(dni);
+    libres[numLibres++] = ficha;
+    Anillo &a = niveles[prioridad];
+    if (--a.vivos == 0)
+    {
+        // Nivel sin vigentes: se vacía de una vez, sin recorrer
+        a.inicio = 0;
+        a.cantidad = 0;
+        mascara &= ~(1u << prioridad);
+    }
+    else if ((a.cantidad - a.vivos) * 4 > a.cantidad)
+    {
+        // Cada descartada paga su parte de la compactación: O(1) amortizado
+        compactar(a);
+    }
+    --tamanio;
+}
+
+void ColaPorNiveles::insertar(long dni, const std::string &perfil, long ts)
+{
+    encolar(dni, perfilAPrioridad(perfil), ts);
+}
+
+void ColaPorNiveles::insertarLote(const Elemento *lote, int n)
+{
+    for (int i = 0; i < n; ++i)
+        encolar(lote[i].dni, lote[i].prioridad, lote[i].ts);
+}
+
+Elemento ColaPorNiveles::extraerMax()
+{
+    if (tamanio == 0)
+    {
+        return {0, 0, 0}; // dni = 0 prioridad = 0 ts = 0
+    }
+    // Nivel más alto con vivos: bit más significativo de la máscara
+    int p = 31 - __builtin_clz(mascara);
+    Anillo &a = niveles[p];
+    // Descarta del frente las entradas reemplazadas o eliminadas
+    while (!vigente(en(a, 0)))
+    {
+        a.inicio = (a.inicio + 1) & (a.capacidad - 1);
+        --a.cantidad;
+    }
+    Entrada e = en(a, 0);
+    a.inicio = (a.inicio + 1) & (a.capacidad - 1);
+    --a.cantidad;
+    descartar(e.dni, vigentes.obtener(e.dni));
+    return {e.dni, p, e.ts};
+}
+
+// La entrada vieja queda en su nivel como descartada; se encola una nueva
+// con el mismo ts para no perder el lugar por orden de llegada (ver encolar)
+bool ColaPorNiveles::actualizarPrioridadDni(long dni, int nuevaPrio)
+{
+    int f = vigentes.obtener(dni);
+    if (f < 0)
+        return false;
+    long ts = fichas[f].ts;
+    descartar(dni, f);
+    encolar(dni, nuevaPrio, ts);
+    return true;
+}
+
+bool ColaPorNiveles::eliminarPorDni(long dni)
+{
+    int f = vigentes.obtener(dni);
+    if (f < 0)
+        return false;
+    descartar(dni, f);
+    return true;
+}
+
+// Recorre los niveles de mayor a menor siguiendo la máscara y copia las
+// entradas vigentes en orden FIFO hasta juntar k. Las descartadas que salta
+// están acotadas por la compactación de descartar
+Elemento *ColaPorNiveles::verTopK(int k, int &outCount) const
+{
+    int n = (tamanio < k ? tamanio : k);
+    if (n < 0)
+        n = 0;
+    Elemento *top = new Elemento[n];
+    int c = 0;
+    unsigned m = mascara;
+    while (c < n && m)
+    {
+        int p = 31 - __builtin_clz(m);
+        m &= ~(1u << p);
+        const Anillo &a = niveles[p];
+        for (int i = 0; i < a.cantidad && c < n; ++i)
+        {
+            const Entrada &e = en(a, i);
+            if (vigente(e))
+                top[c++] = {e.dni, p, e.ts};
+        }
+    }
+    outCount = c;
+    return top;
+}
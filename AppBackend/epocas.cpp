@@ -0,0 +1,144 @@
+#include "epocas.h"
+
+// Devuelve el registro al terminar el hilo, para que otro lo reutilice
+struct LiberarRegistroAlSalir
+{
+    DominioEpocas::RegistroHilo *registro = nullptr;
+    ~LiberarRegistroAlSalir()
+    {
+        if (registro)
+        {
+            registro->anuncio.store(0, std::memory_order_release);
+            registro->enUso.store(false, std::memory_order_release);
+        }
+    }
+};
+
+static thread_local LiberarRegistroAlSalir registroLocal;
+
+DominioEpocas::DominioEpocas()
+    : epoca(1), registros(nullptr)
+{
+}
+
+DominioEpocas::~DominioEpocas()
+{
+    for (const Retirado &r : retirados)
+        r.liberar(r.ptr);
+    RegistroHilo *r = registros.load();
+    while (r)
+    {
+        RegistroHilo *sig = r->siguiente;
+        delete r;
+        r = sig;
+    }
+}
+
+DominioEpocas &DominioEpocas::global()
+{
+    static DominioEpocas dominio;
+    return dominio;
+}
+
+// Primero se intenta reutilizar un registro libre; si no hay, se agrega uno
+// al frente de la lista con CAS
+DominioEpocas::RegistroHilo *DominioEpocas::registroDelHilo()
+{
+    if (registroLocal.registro)
+        return registroLocal.registro;
+
+    for (RegistroHilo *r = registros.load(std::memory_order_acquire); r; r = r->siguiente)
+    {
+        bool libre = false;
+        if (!r->enUso.load(std::memory_order_relaxed) &&
+            r->enUso.compare_exchange_strong(libre, true, std::memory_order_acq_rel))
+        {
+            r->anidamiento = 0;
+            registroLocal.registro = r;
+            return r;
+        }
+    }
+
+    RegistroHilo *nuevo = new RegistroHilo;
+    nuevo->anuncio.store(0, std::memory_order_relaxed);
+    nuevo->enUso.store(true, std::memory_order_relaxed);
+    nuevo->anidamiento = 0;
+    RegistroHilo *cabeza = registros.load(std::memory_order_relaxed);
+    do
+    {
+        nuevo->siguiente = cabeza;
+    } while (!registros.compare_exchange_weak(cabeza, nuevo, std::memory_order_release,
+                                              std::memory_order_relaxed));
+    registroLocal.registro = nuevo;
+    return nuevo;
+}
+
+void DominioEpocas::entrar(RegistroHilo *r)
+{
+    if (r->anidamiento++ > 0)
+        return;
+    r->anuncio.store((epoca.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_relaxed);
+    // El anuncio tiene que ser visible antes de leer cualquier puntero
+    // compartido; se empareja con la barrera de intentarAvanzar
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void DominioEpocas::salir(RegistroHilo *r)
+{
+    if (--r->anidamiento > 0)
+        return;
+    r->anuncio.store(0, std::memory_order_release);
+}
+
+bool DominioEpocas::intentarAvanzar()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t actual = epoca.load(std::memory_order_relaxed);
+    for (RegistroHilo *r = registros.load(std::memory_order_acquire); r; r = r->siguiente)
+    {
+        uint64_t a = r->anuncio.load(std::memory_order_acquire);
+        if ((a & 1) && (a >> 1) != actual)
+            return false;
+    }
+    return epoca.compare_exchange_strong(actual, actual + 1, std::memory_order_acq_rel);
+}
+
+void DominioEpocas::retirar(void *p, void (*liberar)(void *))
+{
+    std::lock_guard<std::mutex> lk(mutexRetirados);
+    retirados.push_back({p, liberar, epoca.load(std::memory_order_acquire)});
+}
+
+int DominioEpocas::recolectar()
+{
+    {
+        std::lock_guard<std::mutex> lk(mutexRetirados);
+        if (retirados.empty())
+            return 0;
+    }
+    intentarAvanzar();
+    std::vector<Retirado> listos;
+    {
+        std::lock_guard<std::mutex> lk(mutexRetirados);
+        uint64_t actual = epoca.load(std::memory_order_acquire);
+        size_t quedan = 0;
+        for (size_t i = 0; i < retirados.size(); ++i)
+        {
+            if (retirados[i].epoca + 2 <= actual)
+                listos.push_back(retirados[i]);
+            else
+                retirados[quedan++] = retirados[i];
+        }
+        retirados.resize(quedan);
+    }
+    // Se libera fuera del mutex
+    for (const Retirado &r : listos)
+        r.liberar(r.ptr);
+    return static_cast<int>(listos.size());
+}
+
+int DominioEpocas::getPendientes()
+{
+    std::lock_guard<std::mutex> lk(mutexRetirados);
+    return static_cast<int>(retirados.size());
+}
@@ -1,140 +1,224 @@
 #include "hash_table.h"
+#include "grupo_control.h"
 #include <iostream>
+#include <cstdlib>
+
+// Redondea hacia arriba a potencia de dos (mínimo un grupo)
+static int potenciaDeDos(int n)
+{
+    int p = TablaHash::TAM_GRUPO;
+    while (p < n)
+        p *= 2;
+    return p;
+}
 
 TablaHash::TablaHash(int tamano_inicial, float carga_maxima)
-    : tam(tamano_inicial), usados(0), cargaMaxima(carga_maxima)
+    : tam(potenciaDeDos(tamano_inicial)), usados(0), cargaMaxima(carga_maxima),
+      bloques(nullptr), numBloques(0), capBloques(0),
+      viejoControl(nullptr), viejosSlots(nullptr), viejoTam(0), gruposMigrados(0)
 {
-    tabla = new NodoHash *[tam];
-    for (int i = 0; i < tam; ++i)
-        tabla[i] = nullptr;
+    control = static_cast<uint8_t *>(std::calloc(tam, 1));
+    slots = new SlotHash[tam];
 }
 
 TablaHash::~TablaHash()
 {
-    for (int i = 0; i < tam; ++i)
+    for (int b = 0; b < numBloques; ++b)
+        delete[] bloques[b];
+    delete[] bloques;
+    std::free(control);
+    delete[] slots;
+    std::free(viejoControl);
+    delete[] viejosSlots;
+}
+
+// Mezcla multiplicativa: los DNIs son casi consecutivos, así que se
+// reparten los bits antes de separar h1 (grupo) y h2 (byte de control)
+uint64_t TablaHash::hashFunc(long clave)
+{
+    uint64_t h = static_cast<uint64_t>(clave) * 0x9E3779B97F4A7C15ull;
+    return h ^ (h >> 32);
+}
+
+// Sondeo por grupos: primero se filtra por h2 con una sola comparación SIMD,
+// luego se confirma el DNI en el arreglo plano de slots. Un grupo con algún
+// slot vacío corta la búsqueda. El salto triangular recorre todos los grupos.
+int TablaHash::buscarEn(const uint8_t *ctrl, const SlotHash *sl, int n, long dni)
+{
+    uint64_t h = hashFunc(dni);
+    uint8_t h2 = static_cast<uint8_t>(OCUPADO | (h & 0x7F));
+    int mascaraGrupos = n / TAM_GRUPO - 1;
+    int g = static_cast<int>(h >> 7) & mascaraGrupos;
+    for (int salto = 1;; ++salto)
+    {
+        int base = g * TAM_GRUPO;
+        unsigned m = coincidencias(ctrl + base, h2);
+        while (m)
+        {
+            int slot = base + __builtin_ctz(m);
+            if (sl[slot].dni == dni)
+                return sl[slot].id;
+            m &= m - 1;
+        }
+        if (vacios(ctrl + base))
+            return -1;
+        g = (g + salto) & mascaraGrupos;
+    }
+}
+
+// Durante una migración un DNI puede estar solo en el arreglo viejo, o en
+// ambos (los slots viejos no se borran); los dos apuntan al mismo registro
+int TablaHash::buscarId(long dni) const
+{
+    int id = buscarEn(control, slots, tam, dni);
+    if (id < 0 && viejoControl)
+        id = buscarEn(viejoControl, viejosSlots, viejoTam, dni);
+    return id;
+}
+
+void TablaHash::colocarEn(uint8_t *ctrl, SlotHash *sl, int n, long dni, int id)
+{
+    uint64_t h = hashFunc(dni);
+    int mascaraGrupos = n / TAM_GRUPO - 1;
+    int g = static_cast<int>(h >> 7) & mascaraGrupos;
+    for (int salto = 1;; ++salto)
+    {
+        int base = g * TAM_GRUPO;
+        unsigned m = vacios(ctrl + base);
+        if (m)
+        {
+            int slot = base + __builtin_ctz(m);
+            ctrl[slot] = static_cast<uint8_t>(OCUPADO | (h & 0x7F));
+            sl[slot].dni = dni;
+            sl[slot].id = id;
+            return;
+        }
+        g = (g + salto) & mascaraGrupos;
+    }
+}
+
+int TablaHash::nuevoRegistro(long dni, const std::string &perfil)
+{
+    int id = usados;
+    if (id % TAM_BLOQUE == 0)
     {
-        NodoHash *actual = tabla[i];
-        while (actual)
+        if (numBloques == capBloques)
         {
-            NodoHash *aBorrar = actual;
-            actual = actual->siguiente;
-            delete aBorrar;
+            int nuevaCap = capBloques ? capBloques * 2 : 4;
+            NodoHash **nuevo = new NodoHash *[nuevaCap];
+            for (int b = 0; b < numBloques; ++b)
+                nuevo[b] = bloques[b];
+            delete[] bloques;
+            bloques = nuevo;
+            capBloques = nuevaCap;
         }
+        bloques[numBloques++] = new NodoHash[TAM_BLOQUE];
     }
-    delete[] tabla;
+    NodoHash *nodo = getUsuario(id);
+    nodo->dni = dni;
+    nodo->perfil = perfil;
+    return id;
 }
-// DNI % 17 = 54345985349853
-int TablaHash::hashFunc(long clave) const
+
+void TablaHash::actualizarPendiente(int id)
 {
-    long h = clave < 0 ? -clave : clave;
-    return static_cast<int>(h % tam);
+    NodoHash *nodo = getUsuario(id);
+    bool estaba = nodo->posPendiente >= 0;
+    if (nodo->pendiente() == estaba)
+        return;
+    if (!estaba)
+    {
+        nodo->posPendiente = static_cast<int>(pendientes.size());
+        pendientes.push_back(id);
+        return;
+    }
+    int ultimo = pendientes.back();
+    pendientes[nodo->posPendiente] = ultimo;
+    getUsuario(ultimo)->posPendiente = nodo->posPendiente;
+    pendientes.pop_back();
+    nodo->posPendiente = -1;
 }
 
 void TablaHash::insertar(long dni, const std::string &perfil)
 {
+    migrarPaso();
     if (static_cast<float>(usados + 1) / tam > cargaMaxima)
     {
         rehash();
     }
-    int idx = hashFunc(dni);
-    NodoHash *nuevo = new NodoHash(dni, perfil);
-    nuevo->enCola = false;
-    nuevo->atendido = false;
-    nuevo->siguiente = tabla[idx];
-    tabla[idx] = nuevo;
+    int id = nuevoRegistro(dni, perfil);
+    colocarEn(control, slots, tam, dni, id);
     ++usados;
+    actualizarPendiente(id);
 }
 
 // buscar un usuario
 NodoHash *TablaHash::buscar(long dni) const
 {
-    int idx = hashFunc(dni);
-    NodoHash *actual = tabla[idx];
-    while (actual)
-    {
-        if (actual->dni == dni)
-            return actual;
-        actual = actual->siguiente;
-    }
-    return nullptr;
+    int id = buscarId(dni);
+    return id < 0 ? nullptr : getUsuario(id);
 }
 
 bool TablaHash::validar(long dni) const
 {
-    return buscar(dni) != nullptr;
+    return buscarId(dni) >= 0;
 }
 
-// Rehashing: duplica el tamaño de la tabla y reubica todos los elementos
+// Rehashing incremental: reserva un arreglo del doble de slots y deja el
+// actual como "viejo". Los slots se copian de a poco en migrarPaso(), así
+// ninguna inserción paga el costo de recorrer toda la tabla.
 void TablaHash::rehash()
 {
-    int nuevoTam = tam * 2 + 1;
-    NodoHash **vieja = tabla;
+    // Con GRUPOS_POR_PASO >= 1 la migración termina mucho antes de volver a
+    // llenar la tabla nueva; por si acaso, se completa antes de crecer otra vez
+    while (viejoControl)
+        migrarPaso();
 
-    tabla = new NodoHash *[nuevoTam];
-    for (int i = 0; i < nuevoTam; ++i)
-        tabla[i] = nullptr;
+    viejoControl = control;
+    viejosSlots = slots;
+    viejoTam = tam;
+    gruposMigrados = 0;
 
-    int viejoTam = tam;
-    tam = nuevoTam;
-    usados = 0;
-
-    // Recorre todos los buckets de la tabla vieja y reinserta cada nodo en la nueva tabla
-    for (int i = 0; i < viejoTam; ++i)
-    {
-        NodoHash *actual = vieja[i];
-        while (actual)
-        {
-            insertar(actual->dni, actual->perfil);
-            NodoHash *siguiente = actual->siguiente;
-            delete actual;
-            actual = siguiente;
-        }
-    }
-    delete[] vieja;
+    tam *= 2;
+    control = static_cast<uint8_t *>(std::calloc(tam, 1));
+    slots = new SlotHash[tam];
 }
 
-// Busca nodo por perfil (clave de conteo)
-NodoHash *TablaHash::buscarPorPerfil(const std::string &perfil) const
+// Copia los slots ocupados de los siguientes grupos viejos al arreglo nuevo.
+// Los registros no se copian ni se liberan: solo se mueven (dni, id).
+void TablaHash::migrarPaso()
 {
-    for (int i = 0; i < tam; ++i)
+    if (!viejoControl)
+        return;
+    int totalGrupos = viejoTam / TAM_GRUPO;
+    int hasta = gruposMigrados + GRUPOS_POR_PASO;
+    if (hasta > totalGrupos)
+        hasta = totalGrupos;
+    for (int i = gruposMigrados * TAM_GRUPO; i < hasta * TAM_GRUPO; ++i)
     {
-        NodoHash *n = tabla[i];
-        while (n)
-        {
-            if (n->perfil == perfil)
-                return n;
-            n = n->siguiente;
-        }
+        if (viejoControl[i] & OCUPADO)
+            colocarEn(control, slots, tam, viejosSlots[i].dni, viejosSlots[i].id);
     }
-    return nullptr;
-}
-
-// Incrementa el contador asociado a un perfil
-void TablaHash::incrementar(const std::string &clave)
-{
-    NodoHash *n = buscarPorPerfil(clave);
-    if (!n)
+    gruposMigrados = hasta;
+    if (gruposMigrados == totalGrupos)
     {
-        insertar(0, clave);
-        n = buscarPorPerfil(clave);
+        std::free(viejoControl);
+        delete[] viejosSlots;
+        viejoControl = nullptr;
+        viejosSlots = nullptr;
+        viejoTam = 0;
     }
-    n->contador++;
-}
-
-// Obtiene el contador asociado a un perfil
-int TablaHash::obtenerConteo(const std::string &clave) const
-{
-    NodoHash *n = buscarPorPerfil(clave);
-    return n ? n->contador : 0;
 }
 
 // Marca si un usuario esta actualmente en la cola
 void TablaHash::marcarEnCola(long dni, bool estado)
 {
-    NodoHash *nodo = buscar(dni);
-    if (nodo)
+    migrarPaso();
+    int id = buscarId(dni);
+    if (id >= 0)
     {
-        nodo->enCola = estado;
+        getUsuario(id)->enCola = estado;
+        actualizarPendiente(id);
     }
     else
     {
@@ -145,10 +229,12 @@ void TablaHash::marcarEnCola(long dni, bool estado)
 // Marca si un usuario ya fue atendido (extraido)
 void TablaHash::marcarAtendido(long dni, bool estado)
 {
-    NodoHash *nodo = buscar(dni);
-    if (nodo)
+    migrarPaso();
+    int id = buscarId(dni);
+    if (id >= 0)
     {
-        nodo->atendido = estado;
+        getUsuario(id)->atendido = estado;
+        actualizarPendiente(id);
     }
     else
     {
@@ -0,0 +1,349 @@
+#include "hash_table_concurrente.h"
+#include "hash_table.h"
+#include "grupo_control.h"
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+TablaHashConcurrente::ArregloHash::ArregloHash(int n)
+    : tam(n), anterior(nullptr)
+{
+    control = static_cast<uint8_t *>(std::calloc(tam, 1));
+    slots = new SlotConcurrente[tam];
+}
+
+TablaHashConcurrente::ArregloHash::~ArregloHash()
+{
+    std::free(control);
+    delete[] slots;
+}
+
+TablaHashConcurrente::Fragmento::Fragmento()
+    : arreglo(new ArregloHash(SLOTS_POR_GRUPO)), usados(0), gruposMigrados(0), cantidad(0), numPendientes(0)
+{
+    for (int b = 0; b < MAX_BLOQUES; ++b)
+        bloques[b].store(nullptr, std::memory_order_relaxed);
+}
+
+// Al destruir la tabla ya no hay lectores: se libera todo directamente
+TablaHashConcurrente::Fragmento::~Fragmento()
+{
+    for (int id = 0; id < usados; ++id)
+    {
+        RegistroUsuario *b = bloques[id / TAM_BLOQUE].load(std::memory_order_relaxed);
+        delete b[id % TAM_BLOQUE].perfil.load(std::memory_order_relaxed);
+    }
+    for (int b = 0; b < MAX_BLOQUES; ++b)
+        delete[] bloques[b].load(std::memory_order_relaxed);
+    ArregloHash *a = arreglo.load(std::memory_order_relaxed);
+    delete a->anterior.load(std::memory_order_relaxed);
+    delete a;
+}
+
+TablaHashConcurrente::TablaHashConcurrente(int num_fragmentos, float carga_maxima)
+    : numFragmentos(1), bitsFragmento(0), cargaMaxima(carga_maxima)
+{
+    // Con a lo sumo 2^10 fragmentos, MAX_BLOQUES * TAM_BLOQUE (2^22)
+    // registros por fragmento siguen formando ids globales de 32 bits
+    while (numFragmentos < num_fragmentos && bitsFragmento < 10)
+    {
+        numFragmentos *= 2;
+        ++bitsFragmento;
+    }
+    fragmentos = new Fragmento[numFragmentos];
+}
+
+TablaHashConcurrente::~TablaHashConcurrente()
+{
+    delete[] fragmentos;
+}
+
+// Bits altos del hash: los bajos ubican el slot dentro del fragmento
+TablaHashConcurrente::Fragmento &TablaHashConcurrente::fragmentoDe(long dni) const
+{
+    if (bitsFragmento == 0)
+        return fragmentos[0];
+    uint64_t h = TablaHash::hashFunc(dni);
+    return fragmentos[h >> (64 - bitsFragmento)];
+}
+
+// Mismo sondeo por grupos que TablaHash. La carga SIMD del grupo puede
+// cruzarse con un escritor publicando un byte: cada coincidencia se confirma
+// con una carga acquire del byte, que garantiza ver el slot completo. Un
+// slot que todavía se ve vacío equivale a buscar antes de la inserción
+RegistroUsuario *TablaHashConcurrente::buscarEn(const ArregloHash *a, long dni)
+{
+    uint64_t h = TablaHash::hashFunc(dni);
+    uint8_t h2 = static_cast<uint8_t>(OCUPADO | (h & 0x7F));
+    int mascaraGrupos = a->tam / SLOTS_POR_GRUPO - 1;
+    int g = static_cast<int>(h >> 7) & mascaraGrupos;
+    for (int salto = 1;; ++salto)
+    {
+        int base = g * SLOTS_POR_GRUPO;
+        unsigned m = coincidencias(a->control + base, h2);
+        while (m)
+        {
+            int slot = base + __builtin_ctz(m);
+            if (__atomic_load_n(&a->control[slot], __ATOMIC_ACQUIRE) == h2 &&
+                a->slots[slot].dni == dni)
+                return a->slots[slot].registro;
+            m &= m - 1;
+        }
+        if (vacios(a->control + base))
+            return nullptr;
+        g = (g + salto) & mascaraGrupos;
+    }
+}
+
+// Solo el escritor del fragmento: completa el slot y recién después publica
+// su byte de control
+void TablaHashConcurrente::colocarEn(ArregloHash *a, long dni, RegistroUsuario *r)
+{
+    uint64_t h = TablaHash::hashFunc(dni);
+    int mascaraGrupos = a->tam / SLOTS_POR_GRUPO - 1;
+    int g = static_cast<int>(h >> 7) & mascaraGrupos;
+    for (int salto = 1;; ++salto)
+    {
+        int base = g * SLOTS_POR_GRUPO;
+        unsigned m = vacios(a->control + base);
+        if (m)
+        {
+            int slot = base + __builtin_ctz(m);
+            a->slots[slot].dni = dni;
+            a->slots[slot].registro = r;
+            __atomic_store_n(&a->control[slot], static_cast<uint8_t>(OCUPADO | (h & 0x7F)), __ATOMIC_RELEASE);
+            return;
+        }
+        g = (g + salto) & mascaraGrupos;
+    }
+}
+
+// El anterior se lee antes de buscar en el nuevo: si la migración termina
+// en el medio, el viejo (que nunca se modifica) sigue teniendo lo que aún
+// no se veía migrado, y las épocas lo mantienen vivo hasta salir
+RegistroUsuario *TablaHashConcurrente::buscarEnArreglos(const ArregloHash *a, long dni)
+{
+    const ArregloHash *anterior = a->anterior.load(std::memory_order_acquire);
+    RegistroUsuario *r = buscarEn(a, dni);
+    if (!r && anterior)
+        r = buscarEn(anterior, dni);
+    return r;
+}
+
+// Publica un arreglo vacío del doble de slots que apunta al actual: desde
+// ahí las inserciones van al nuevo y migrarPaso copia el viejo de a poco.
+// Si la migración anterior no terminó (no debería: el nuevo tarda más en
+// llenarse que en migrarse) se completa antes
+void TablaHashConcurrente::crecer(Fragmento &fr)
+{
+    while (fr.arreglo.load(std::memory_order_relaxed)->anterior.load(std::memory_order_relaxed))
+        migrarPaso(fr);
+    ArregloHash *viejo = fr.arreglo.load(std::memory_order_relaxed);
+    ArregloHash *nuevo = new ArregloHash(viejo->tam * 2);
+    nuevo->anterior.store(viejo, std::memory_order_relaxed);
+    fr.gruposMigrados = 0;
+    fr.arreglo.store(nuevo, std::memory_order_release);
+}
+
+// Copia los slots ocupados sin borrarlos del viejo: un lector que todavía
+// no los ve en el nuevo los encuentra allá
+void TablaHashConcurrente::migrarPaso(Fragmento &fr)
+{
+    ArregloHash *a = fr.arreglo.load(std::memory_order_relaxed);
+    ArregloHash *viejo = a->anterior.load(std::memory_order_relaxed);
+    if (!viejo)
+        return;
+    int grupos = viejo->tam / SLOTS_POR_GRUPO;
+    int fin = fr.gruposMigrados + GRUPOS_POR_PASO < grupos ? fr.gruposMigrados + GRUPOS_POR_PASO : grupos;
+    for (int i = fr.gruposMigrados * SLOTS_POR_GRUPO; i < fin * SLOTS_POR_GRUPO; ++i)
+    {
+        if (viejo->control[i] & OCUPADO)
+            colocarEn(a, viejo->slots[i].dni, viejo->slots[i].registro);
+    }
+    fr.gruposMigrados = fin;
+    if (fin == grupos)
+    {
+        a->anterior.store(nullptr, std::memory_order_release);
+        DominioEpocas::global().retirar(viejo);
+    }
+}
+
+void TablaHashConcurrente::actualizarPendiente(Fragmento &fr, RegistroUsuario *r)
+{
+    bool estaba = r->posPendiente >= 0;
+    if (r->pendiente() == estaba)
+        return;
+    if (!estaba)
+    {
+        r->posPendiente = static_cast<int>(fr.pendientes.size());
+        fr.pendientes.push_back(r);
+    }
+    else
+    {
+        RegistroUsuario *ultimo = fr.pendientes.back();
+        fr.pendientes[r->posPendiente] = ultimo;
+        ultimo->posPendiente = r->posPendiente;
+        fr.pendientes.pop_back();
+        r->posPendiente = -1;
+    }
+    fr.numPendientes.store(static_cast<int>(fr.pendientes.size()), std::memory_order_relaxed);
+}
+
+void TablaHashConcurrente::actualizarFiltros(const RegistroUsuario *r, EstadoUsuario estadoAntes,
+                                             const std::string *perfilAntes)
+{
+    EstadoUsuario estado = r->estado();
+    const std::string *perfil = r->perfil.load(std::memory_order_relaxed);
+    if (estado == estadoAntes && perfil == perfilAntes)
+        return;
+    std::unique_lock<std::shared_mutex> lk(mutexFiltros);
+    if (estado != estadoAntes)
+    {
+        porEstado[estadoAntes].quitar(r->id);
+        porEstado[estado].agregar(r->id);
+    }
+    if (perfil != perfilAntes && *perfil != *perfilAntes)
+    {
+        porPerfil[*perfilAntes].quitar(r->id);
+        porPerfil[*perfil].agregar(r->id);
+    }
+}
+
+const RegistroUsuario *TablaHashConcurrente::registroPorId(uint32_t id) const
+{
+    const Fragmento &fr = fragmentos[id & (numFragmentos - 1)];
+    uint32_t local = id >> bitsFragmento;
+    return &fr.bloques[local / TAM_BLOQUE].load(std::memory_order_acquire)[local % TAM_BLOQUE];
+}
+
+long TablaHashConcurrente::listarIds(EstadoUsuario estado, const std::string *perfil, uint32_t desde,
+                                     int limite, std::vector<uint32_t> &ids) const
+{
+    std::shared_lock<std::shared_mutex> lk(mutexFiltros);
+    const IndiceBitmap *conjuntos[2];
+    int n = 0;
+    if (perfil)
+    {
+        auto it = porPerfil.find(*perfil);
+        if (it == porPerfil.end())
+        {
+            ids.clear();
+            return -1;
+        }
+        conjuntos[n++] = &it->second;
+    }
+    conjuntos[n++] = &porEstado[estado];
+    return IndiceBitmap::interseccion(conjuntos, n, desde, limite, ids);
+}
+
+RegistroUsuario *TablaHashConcurrente::buscarRegistro(long dni) const
+{
+    return buscarEnArreglos(fragmentoDe(dni).arreglo.load(std::memory_order_acquire), dni);
+}
+
+bool TablaHashConcurrente::insertar(long dni, const std::string &perfil)
+{
+    Fragmento &fr = fragmentoDe(dni);
+    {
+        std::lock_guard<std::mutex> lk(fr.escritura);
+        ArregloHash *a = fr.arreglo.load(std::memory_order_relaxed);
+        if (buscarEnArreglos(a, dni))
+            return false;
+
+        int id = fr.usados;
+        int b = id / TAM_BLOQUE;
+        if (b >= MAX_BLOQUES)
+            throw std::length_error("TablaHashConcurrente: fragmento lleno");
+        RegistroUsuario *bloque = fr.bloques[b].load(std::memory_order_relaxed);
+        if (!bloque)
+        {
+            bloque = new RegistroUsuario[TAM_BLOQUE];
+            fr.bloques[b].store(bloque, std::memory_order_relaxed);
+        }
+        RegistroUsuario *r = &bloque[id % TAM_BLOQUE];
+        r->dni = dni;
+        r->id = (static_cast<uint32_t>(id) << bitsFragmento) | static_cast<uint32_t>(&fr - fragmentos);
+        r->perfil.store(new std::string(perfil), std::memory_order_relaxed);
+
+        if (static_cast<float>(fr.usados + 1) / a->tam > cargaMaxima)
+        {
+            crecer(fr);
+            a = fr.arreglo.load(std::memory_order_relaxed);
+        }
+        colocarEn(a, dni, r);
+        migrarPaso(fr);
+        ++fr.usados;
+        fr.cantidad.store(fr.usados, std::memory_order_release);
+        actualizarPendiente(fr, r);
+
+        std::unique_lock<std::shared_mutex> lkFiltros(mutexFiltros);
+        porEstado[ESTADO_PENDIENTE].agregar(r->id);
+        porPerfil[perfil].agregar(r->id);
+    }
+    DominioEpocas::global().recolectar();
+    return true;
+}
+
+bool TablaHashConcurrente::validar(long dni) const
+{
+    GuardaEpoca guarda;
+    return buscarRegistro(dni) != nullptr;
+}
+
+bool TablaHashConcurrente::obtenerPerfil(long dni, std::string &perfil) const
+{
+    return leer(dni, [&](const RegistroUsuario &r)
+                { perfil = r.getPerfil(); });
+}
+
+bool TablaHashConcurrente::cambiarPerfil(long dni, const std::string &perfil)
+{
+    bool encontrado = modificar(dni, [&](RegistroUsuario &r)
+                                {
+        const std::string *viejo = r.perfil.exchange(new std::string(perfil), std::memory_order_acq_rel);
+        DominioEpocas::global().retirar(const_cast<std::string *>(viejo)); });
+    if (encontrado)
+        DominioEpocas::global().recolectar();
+    return encontrado;
+}
+
+void TablaHashConcurrente::marcarEnCola(long dni, bool estado)
+{
+    if (!modificar(dni, [&](RegistroUsuario &r)
+                   { r.enCola.store(estado); }))
+        std::cerr << "marcarEnCola: DNI no encontrado: " << dni << "\n";
+}
+
+void TablaHashConcurrente::marcarAtendido(long dni, bool estado)
+{
+    if (!modificar(dni, [&](RegistroUsuario &r)
+                   { r.atendido.store(estado); }))
+        std::cerr << "marcarAtendido: DNI no encontrado: " << dni << "\n";
+}
+
+int TablaHashConcurrente::getCantidad() const
+{
+    int total = 0;
+    for (int i = 0; i < numFragmentos; ++i)
+        total += fragmentos[i].cantidad.load(std::memory_order_acquire);
+    return total;
+}
+
+bool TablaHashConcurrente::migrando() const
+{
+    GuardaEpoca guarda;
+    for (int i = 0; i < numFragmentos; ++i)
+    {
+        if (fragmentos[i].arreglo.load(std::memory_order_acquire)->anterior.load(std::memory_order_acquire))
+            return true;
+    }
+    return false;
+}
+
+int TablaHashConcurrente::getCantidadPendientes() const
+{
+    int total = 0;
+    for (int i = 0; i < numFragmentos; ++i)
+        total += fragmentos[i].numPendientes.load(std::memory_order_relaxed);
+    return total;
+}
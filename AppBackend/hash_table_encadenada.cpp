@@ -0,0 +1,103 @@
+#include "hash_table_encadenada.h"
+
+TablaHashEncadenada::TablaHashEncadenada(int tamano_inicial, float carga_maxima)
+    : tam(tamano_inicial), usados(0), cargaMaxima(carga_maxima)
+{
+    tabla = new NodoEncadenado *[tam];
+    for (int i = 0; i < tam; ++i)
+        tabla[i] = nullptr;
+}
+
+TablaHashEncadenada::~TablaHashEncadenada()
+{
+    for (int i = 0; i < tam; ++i)
+    {
+        NodoEncadenado *actual = tabla[i];
+        while (actual)
+        {
+            NodoEncadenado *aBorrar = actual;
+            actual = actual->siguiente;
+            delete aBorrar;
+        }
+    }
+    delete[] tabla;
+}
+
+int TablaHashEncadenada::hashFunc(long clave) const
+{
+    long h = clave < 0 ? -clave : clave;
+    return static_cast<int>(h % tam);
+}
+
+void TablaHashEncadenada::insertar(long dni, const std::string &perfil)
+{
+    if (static_cast<float>(usados + 1) / tam > cargaMaxima)
+    {
+        rehash();
+    }
+    int idx = hashFunc(dni);
+    NodoEncadenado *nuevo = new NodoEncadenado(dni, perfil);
+    nuevo->siguiente = tabla[idx];
+    tabla[idx] = nuevo;
+    ++usados;
+}
+
+NodoEncadenado *TablaHashEncadenada::buscar(long dni) const
+{
+    int idx = hashFunc(dni);
+    NodoEncadenado *actual = tabla[idx];
+    while (actual)
+    {
+        if (actual->dni == dni)
+            return actual;
+        actual = actual->siguiente;
+    }
+    return nullptr;
+}
+
+bool TablaHashEncadenada::validar(long dni) const
+{
+    return buscar(dni) != nullptr;
+}
+
+// Rehashing: duplica el tamaño de la tabla y reubica todos los elementos
+void TablaHashEncadenada::rehash()
+{
+    int nuevoTam = tam * 2 + 1;
+    NodoEncadenado **vieja = tabla;
+
+    tabla = new NodoEncadenado *[nuevoTam];
+    for (int i = 0; i < nuevoTam; ++i)
+        tabla[i] = nullptr;
+
+    int viejoTam = tam;
+    tam = nuevoTam;
+    usados = 0;
+
+    for (int i = 0; i < viejoTam; ++i)
+    {
+        NodoEncadenado *actual = vieja[i];
+        while (actual)
+        {
+            insertar(actual->dni, actual->perfil);
+            NodoEncadenado *siguiente = actual->siguiente;
+            delete actual;
+            actual = siguiente;
+        }
+    }
+    delete[] vieja;
+}
+
+void TablaHashEncadenada::marcarEnCola(long dni, bool estado)
+{
+    NodoEncadenado *nodo = buscar(dni);
+    if (nodo)
+        nodo->enCola = estado;
+}
+
+void TablaHashEncadenada::marcarAtendido(long dni, bool estado)
+{
+    NodoEncadenado *nodo = buscar(dni);
+    if (nodo)
+        nodo->atendido = estado;
+}
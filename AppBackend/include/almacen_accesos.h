@@ -0,0 +1,121 @@
+#ifndef ALMACEN_ACCESOS_H
+#define ALMACEN_ACCESOS_H
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+#include "indice_tiempo.h"
+#include "ranking_conteo.h"
+
+class IteradorAccesos;
+
+// Accesos particionados por tiempo: cada partición cubre un intervalo fijo
+// (una hora, un día...) y es un IndiceTiempo independiente. Con retención,
+// las particiones que quedan enteras fuera de la ventana se descartan
+// completas: se liberan sus bloques sin tocar los accesos uno por uno.
+// Las consultas solo visitan las particiones que se solapan con el rango.
+// La secuencia es propia de cada partición; como una partición cubre un
+// intervalo de timestamps, la clave (timestamp, secuencia) sigue siendo única.
+// Un árbol de Fenwick sobre las cantidades de las particiones (en orden de
+// inicio) da el rango y la selección en O(log P + log n), sin recorrer las
+// particiones anteriores. Las particiones descartadas dejan su celda en 0 y
+// el Fenwick sigue con un desplazamiento (base): descartar es O(log P) más
+// liberar el índice, y el Fenwick se compacta recién cuando las celdas
+// muertas superan a las vivas (O(1) amortizado por descarte)
+class AlmacenAccesos
+{
+private:
+    long duracion;  // segundos por partición
+    long retencion; // segundos hacia atrás desde el acceso más nuevo; 0 = sin límite
+    long maxTimestamp;
+    std::deque<long> inicios;                // inicio de cada partición, ordenados
+    std::deque<IndiceTiempo *> particiones;  // en el mismo orden que inicios
+    std::vector<long> acumulado;             // Fenwick (desde 1) de las cantidades
+    size_t base;                             // celdas de particiones ya descartadas
+    long cantidad;
+    RankingConteo conteoZonas; // accesos retenidos por id de zona
+    // Nodos de los rezagados de todas las particiones: al mezclarse vuelven
+    // al pool y los reusa la partición que siga recibiendo rezagados
+    PoolNodos<NodoAVL> nodosRezagados;
+
+    friend class IteradorAccesos;
+
+    long inicioParticion(long ts) const;
+    // La partición que empieza en "inicio" ya quedó entera fuera de la retención
+    bool vencida(long inicio) const;
+    // Posición de la partición que empieza en "inicio", creándola si falta.
+    // Agregar al final es O(log P); una partición nueva en el medio (un
+    // rezagado de una hora sin accesos, raro) reconstruye el Fenwick en O(P)
+    size_t particionPara(long inicio);
+    void descartarVencidas();
+    void insertarAdmitido(int zonaId, long timestamp);
+    // Suma delta a la cantidad de la partición retenida en la posición pos
+    // (celda base + pos + 1 del Fenwick)
+    void sumarCantidad(size_t pos, long delta);
+    // Suma de las celdas 1..celda del Fenwick, contando las descartadas
+    long prefijo(size_t celda) const;
+    // Accesos en las particiones anteriores a la posición pos. O(log P)
+    long cantidadAntes(size_t pos) const;
+    // Rearma el Fenwick solo con las particiones retenidas (base = 0). O(P)
+    void reconstruirAcumulado();
+    // Cuenta los accesos con clave <= (ts, seq)
+    long contarHasta(long ts, long seq) const;
+
+public:
+    explicit AlmacenAccesos(long duracion_particion = 3600, long retencion_seg = 0);
+    ~AlmacenAccesos();
+    AlmacenAccesos(const AlmacenAccesos &) = delete;
+    AlmacenAccesos &operator=(const AlmacenAccesos &) = delete;
+
+    // Devuelve false (y no guarda nada) si el acceso ya está fuera de la
+    // retención, que se mide desde el acceso más nuevo. Rechazar timestamps
+    // adelantados al reloj le toca al llamador
+    bool insertar(int zonaId, long timestamp);
+    // Registra la zona en RegistroZonas (solo si el acceso se admite) y la
+    // inserta por id; false también si el registro de zonas está lleno
+    bool insertar(const std::string &zona, long timestamp);
+    // insertar aceptaría ahora un acceso con ese timestamp
+    bool admite(long timestamp) const { return !vencida(inicioParticion(timestamp)); }
+
+    IteradorAccesos desde(long ts, long seq) const;
+    bool rangoPagina(long desdeTs, long desdeSeq, long fin, int limite,
+                     std::vector<Acceso> &out) const;
+    long contarRango(long inicio, long fin) const;
+    // Posición (desde 0) del primer acceso con timestamp >= ts
+    long posicionDesde(long ts) const { return contarHasta(ts, -1); }
+    bool seleccionar(long k, Acceso &out) const;
+    long getCantidad() const { return cantidad; }
+    int getCantidadParticiones() const { return static_cast<int>(particiones.size()); }
+    size_t getMemoria() const;
+    UsoPool getUsoPoolRezagados() const { return nodosRezagados.getUso(); }
+
+    const std::string &nombreZona(int zonaId) const;
+    std::vector<long> conteoZonasEnRango(long inicio, long fin) const;
+    std::string zonaMasEntradas() const;
+    std::string zonaMasEntradas(long inicio, long fin) const;
+    // Solo zonas con accesos retenidos
+    std::vector<std::pair<std::string, long>> zonasTop(int k) const;
+};
+
+// Recorrido en orden que pasa de una partición a la siguiente
+class IteradorAccesos
+{
+private:
+    const AlmacenAccesos *almacen;
+    size_t particion;
+    IteradorTiempo it;
+    Acceso actual;
+
+    // Salta particiones agotadas
+    void ajustar();
+
+public:
+    IteradorAccesos(const AlmacenAccesos *a, size_t p, IteradorTiempo i);
+    bool valido() const { return almacen != nullptr; }
+    const Acceso &operator*() const { return actual; }
+    const Acceso *operator->() const { return &actual; }
+    IteradorAccesos &operator++();
+};
+
+#endif
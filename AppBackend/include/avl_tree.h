@@ -4,31 +4,91 @@
 
 #include <string>
 #include <vector>
-#include "hash_table.h"
+#include "pool_nodos.h"
+#include "ranking_conteo.h"
+
+// Conteos por id de zona de un subárbol. Los primeros ZONAS_EN_LINEA viven
+// dentro del nodo, así crear un nodo del pool no reserva memoria; solo con
+// más zonas se reserva el resto aparte. Los ids mayores al tamaño tienen cero
+class ConteoZonasNodo
+{
+public:
+    static const int ZONAS_EN_LINEA = 8;
+
+private:
+    int enLinea[ZONAS_EN_LINEA];
+    int tam;
+    int *resto; // ids desde ZONAS_EN_LINEA, tam - ZONAS_EN_LINEA contadores
+
+public:
+    ConteoZonasNodo() : tam(0), resto(nullptr) {}
+    ~ConteoZonasNodo() { delete[] resto; }
+    ConteoZonasNodo(const ConteoZonasNodo &) = delete;
+    ConteoZonasNodo &operator=(const ConteoZonasNodo &) = delete;
+
+    int size() const { return tam; }
+    int operator[](int z) const { return z < ZONAS_EN_LINEA ? enLinea[z] : resto[z - ZONAS_EN_LINEA]; }
+    int &operator[](int z) { return z < ZONAS_EN_LINEA ? enLinea[z] : resto[z - ZONAS_EN_LINEA]; }
+    // Agranda hasta n ids con conteo 0 (nunca achica)
+    void agrandar(int n);
+    // Pone todos los conteos en 0 sin cambiar el tamaño
+    void limpiar();
+    void swap(ConteoZonasNodo &otro);
+    // Bytes reservados fuera del nodo
+    size_t bytesAparte() const { return tam > ZONAS_EN_LINEA ? (tam - ZONAS_EN_LINEA) * sizeof(int) : 0; }
+};
 
 struct NodoAVL
 {
-    std::string zona;
+    int zonaId; // id de la zona en RegistroZonas
     long timestamp;
+    long secuencia; // orden de inserción: desempata accesos con el mismo timestamp
     int altura; // NUEVO: altura del subárbol
     int factor_balance;
+    int tamano; // nodos del subárbol, incluido este
+    ConteoZonasNodo conteoZonasSub; // accesos del subárbol por id de zona
     NodoAVL *izquierdo;
     NodoAVL *derecho;
     NodoAVL *padre;
 
-    NodoAVL(const std::string &z, long ts)
-        : zona(z), timestamp(ts), altura(1), factor_balance(0),
+    NodoAVL(int zid, long ts, long seq)
+        : zonaId(zid), timestamp(ts), secuencia(seq), altura(1), factor_balance(0), tamano(1),
           izquierdo(nullptr), derecho(nullptr), padre(nullptr) {}
 };
 
+// Recorrido in-order sin pila: el sucesor se obtiene con los punteros a
+// padre, así que el iterador ocupa un puntero sin importar el tamaño del rango
+class IteradorAVL
+{
+private:
+    NodoAVL *actual;
+
+public:
+    explicit IteradorAVL(NodoAVL *n = nullptr) : actual(n) {}
+    bool valido() const { return actual != nullptr; }
+    NodoAVL *operator*() const { return actual; }
+    NodoAVL *operator->() const { return actual; }
+    // Avanza al siguiente en orden (timestamp, secuencia). O(1) amortizado
+    IteradorAVL &operator++();
+};
+
 class ArbolAVL
 {
 private:
     NodoAVL *raiz;
+    PoolNodos<NodoAVL> *nodos;      // de donde salen los nodos
+    PoolNodos<NodoAVL> *poolPropio; // nullptr si el pool es ajeno
+    long siguienteSecuencia;
+    RankingConteo conteoZonas; // accesos por id de zona, actualizado en cada insercion
 
-    NodoAVL *insertarRecursivo(NodoAVL *nodo, const std::string &zona, long ts);
+    NodoAVL *insertarRecursivo(NodoAVL *nodo, int zonaId, long ts, long seq);
     // int altura(NodoAVL* nodo); // ELIMINAR: ya no se usa
     void actualizarFactor(NodoAVL *nodo);
+    // Recalcula conteoZonasSub desde los hijos (tras una rotación)
+    void actualizarZonas(NodoAVL *nodo);
+    static void sumarZona(NodoAVL *nodo, int zonaId);
+    // Suma en acum, por zona, los accesos con clave <= (ts, seq)
+    void contarZonasHasta(long ts, long seq, std::vector<long> &acum, long signo) const;
     NodoAVL *reBalancear(NodoAVL *nodo);
     NodoAVL *rotarIzquierda(NodoAVL *nodo);
     NodoAVL *rotarDerecha(NodoAVL *nodo);
@@ -36,14 +96,59 @@ private:
 
     void rangoRec(NodoAVL *nodo, long inicio, long fin,
                   std::vector<NodoAVL *> &out);
-    void contarZonas(NodoAVL *nodo, TablaHash &cnt);
+    void liberarRec(NodoAVL *nodo);
 
 public:
-    ArbolAVL();
+    // Sin pool, el árbol usa uno propio. Varios árboles que se modifican
+    // desde el mismo hilo pueden compartir uno
+    explicit ArbolAVL(PoolNodos<NodoAVL> *pool = nullptr);
+    ~ArbolAVL();
+    ArbolAVL(const ArbolAVL &) = delete;
+    ArbolAVL &operator=(const ArbolAVL &) = delete;
+
+    // Devuelve todos los nodos al pool y deja el árbol vacío
+    void vaciar();
 
+    // Registra la zona en RegistroZonas y la inserta por id (nada si el
+    // registro de zonas está lleno)
     void insertar(const std::string &zona, long timestamp);
+    void insertar(int zonaId, long timestamp);
+    // Con una secuencia dada desde afuera, que debe ser mayor que todas las
+    // anteriores (para compartir el orden con otro índice)
+    void insertar(int zonaId, long timestamp, long secuencia);
     std::vector<NodoAVL *> rangoTiempos(long inicio, long fin);
+    // Primer acceso con clave (timestamp, secuencia) posterior a la dada.
+    // desde(inicio, -1) es el primero con timestamp >= inicio. O(log n)
+    IteradorAVL desde(long ts, long seq) const;
+    // Hasta "limite" accesos con timestamp <= fin posteriores a la clave
+    // (desdeTs, desdeSeq), en orden. Para la primera página usar
+    // (inicio, -1). O(log n + limite). Devuelve true si quedan más después
+    // de la página
+    bool rangoPagina(long desdeTs, long desdeSeq, long fin, int limite,
+                     std::vector<NodoAVL *> &out);
+
+    // Estadísticas de orden con los tamaños de subárbol, todas O(log n):
+    // Accesos con clave (timestamp, secuencia) menor o igual a la dada
+    long contarHasta(long ts, long seq) const;
+    // Accesos con inicio <= timestamp <= fin, sin recorrerlos
+    long contarRango(long inicio, long fin) const;
+    // El k-ésimo acceso en orden de tiempo (desde 0), o nullptr
+    NodoAVL *seleccionar(long k) const;
+    long getCantidad() const { return raiz ? raiz->tamano : 0; }
+    // Bytes de los nodos y sus conteos por zona
+    size_t getMemoria() const;
+    UsoPool getUsoPool() const { return nodos->getUso(); }
+    // Nombre de un id de zona de conteoZonasEnRango
+    const std::string &nombreZona(int zonaId) const;
+
     std::string zonaMasEntradas();
+    // Accesos por id de zona con inicio <= timestamp <= fin, sumando los
+    // conteos de O(log n) subárboles: O(log n · zonas)
+    std::vector<long> conteoZonasEnRango(long inicio, long fin) const;
+    // Zona con más accesos en la ventana, vacía si no hubo ninguno
+    std::string zonaMasEntradas(long inicio, long fin) const;
+    // Las k zonas con mas accesos y su conteo, de mayor a menor. O(k)
+    std::vector<std::pair<std::string, long>> zonasTop(int k);
     void mostrar();
 };
 
@@ -0,0 +1,103 @@
+#ifndef BUCLE_ESCRITOR_H
+#define BUCLE_ESCRITOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+// Comando a ejecutar en el hilo escritor. Vive en la pila del hilo que lo
+// encola, que espera su resultado. El aviso de fin (mutex, condición y
+// bandera) va dentro del comando, así encolar no reserva memoria dinámica
+struct Comando
+{
+    std::atomic<Comando *> siguiente;
+    void (*ejecutar)(void *); // trampolín hacia la lambda del handler
+    void *contexto;
+    std::mutex mutexFin;
+    std::condition_variable fin;
+    bool terminado;
+    std::exception_ptr error;
+};
+
+// Cola MPSC sin locks (algoritmo intrusivo de Vyukov): varios productores
+// encolan con un solo exchange atómico; un único consumidor desencola
+class ColaMPSC
+{
+private:
+    std::atomic<Comando *> cabeza; // último encolado (lado productores)
+    Comando *cola;                 // próximo a desencolar (lado consumidor)
+    Comando centinela;
+
+public:
+    ColaMPSC();
+    void encolar(Comando *c);
+    // Solo el consumidor. nullptr si está vacía o un productor está a mitad
+    // de encolar (en ese caso el comando aparece en la próxima llamada)
+    Comando *desencolar();
+    bool vacia() const;
+};
+
+// Bucle de un solo escritor: los handlers HTTP que modifican las estructuras
+// encolan comandos y esperan; un hilo dueño los aplica por lotes. Mientras
+// aplica un lote toma la vista en modo exclusivo, así las lecturas que toman
+// la vista en modo compartido siempre ven el estado entre dos lotes.
+class BucleEscritor
+{
+public:
+    static const int LOTE_MAXIMO = 64; // comandos aplicados por lote
+
+private:
+    ColaMPSC pendientes;
+    std::thread hilo;
+    std::atomic<bool> activo;
+    std::atomic<bool> durmiendo;
+    std::mutex mutexDormir;
+    std::condition_variable despertar;
+    std::shared_mutex mutexVista;
+    std::function<void()> alTerminarLote; // publica vistas, bajo lock exclusivo
+
+    void encolar(Comando *c);
+    void bucle();
+    // Aplica hasta LOTE_MAXIMO comandos; devuelve cuántos aplicó
+    int aplicarLote();
+
+public:
+    BucleEscritor();
+    ~BucleEscritor();
+    BucleEscritor(const BucleEscritor &) = delete;
+    BucleEscritor &operator=(const BucleEscritor &) = delete;
+
+    // Arranca el hilo escritor. alTerminarLote se llama una vez al inicio y
+    // después de cada lote, con la vista tomada en modo exclusivo
+    void iniciar(std::function<void()> alTerminarLoteFn);
+    void detener();
+
+    // Ejecuta f en el hilo escritor y espera a que termine (con la vista ya
+    // publicada). Si f lanza una excepción, se relanza aquí
+    template <typename F>
+    void ejecutar(F &&f)
+    {
+        Comando c;
+        c.ejecutar = [](void *p)
+        { (*static_cast<typename std::remove_reference<F>::type *>(p))(); };
+        c.contexto = &f;
+        c.terminado = false;
+        encolar(&c);
+        {
+            std::unique_lock<std::mutex> lk(c.mutexFin);
+            c.fin.wait(lk, [&c]
+                       { return c.terminado; });
+        }
+        if (c.error)
+            std::rethrow_exception(c.error);
+    }
+
+    // Lock para lecturas consistentes: std::shared_lock<std::shared_mutex>
+    std::shared_mutex &vista() { return mutexVista; }
+};
+
+#endif
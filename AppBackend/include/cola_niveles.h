@@ -0,0 +1,108 @@
+#ifndef COLA_NIVELES_H
+#define COLA_NIVELES_H
+
+#include <string>
+#include "max_heap.h"
+#include "indice_dni.h"
+
+// Cola de prioridad por niveles (bucket queue): como los perfiles solo se
+// traducen a 6 prioridades (0 a 5), se guarda una cola FIFO circular por
+// nivel y una máscara de bits con los niveles no vacíos, sin comparaciones
+// entre usuarios. Dentro de un nivel se respeta el orden de llegada por ts:
+// un usuario con un ts anterior al último de su nivel se ubica por búsqueda
+// binaria y se corre el extremo más cercano del anillo, así que ese
+// insertar cuesta O(log m + desplazados), con m el tamaño del nivel (los del
+// servidor llegan en orden y no mueven nada; un cambio de prioridad conserva
+// su ts y suele caer cerca del frente).
+//
+// Expone la misma interfaz que MaxHeap para poder elegir el motor en main.
+// Los cambios de prioridad y las bajas se resuelven de forma perezosa: la
+// entrada vieja queda en su nivel y se descarta al encontrarla. Cuando las
+// descartadas pasan de un cuarto de un anillo, se compacta. Así extraer el
+// máximo cuesta O(1) amortizado y ver el top-k O(k + d), con d las
+// descartadas que quedan en los niveles recorridos (menos de un tercio de
+// sus vigentes).
+class ColaPorNiveles
+{
+public:
+    static const int NIVELES = 6;
+
+private:
+    struct Entrada
+    {
+        long dni;
+        long ts;
+        long seq; // identifica la entrada vigente de ese DNI
+    };
+
+    // Datos de la entrada vigente de cada DNI en cola
+    struct Ficha
+    {
+        long seq;
+        int prioridad;
+        long ts;
+    };
+
+    struct Anillo
+    {
+        Entrada *datos;
+        int capacidad; // potencia de dos
+        int inicio;
+        int cantidad; // entradas guardadas, incluidas las descartadas
+        int vivos;    // entradas vigentes
+    };
+
+    Anillo niveles[NIVELES];
+    unsigned mascara;     // bit p encendido si el nivel p tiene vivos
+    int tamanio;          // usuarios en cola
+    long siguienteSeq;    // contador para marcar entradas (no da la vuelta)
+    IndiceDni vigentes;   // DNI -> posición de su ficha
+    Ficha *fichas;        // fichas de los DNIs en cola
+    int *libres;          // pila de posiciones de fichas libres
+    int numLibres;
+    int capFichas;
+
+    Entrada &en(Anillo &a, int i) { return a.datos[(a.inicio + i) & (a.capacidad - 1)]; }
+    const Entrada &en(const Anillo &a, int i) const { return a.datos[(a.inicio + i) & (a.capacidad - 1)]; }
+    bool vigente(const Entrada &e) const
+    {
+        int f = vigentes.obtener(e.dni);
+        return f >= 0 && fichas[f].seq == e.seq;
+    }
+    // Quita las entradas descartadas del anillo
+    void compactar(Anillo &a);
+    void expandir(Anillo &a);
+    void encolar(long dni, int prioridad, long ts);
+    // Marca como descartada la entrada vigente de un DNI en cola
+    void descartar(long dni, int ficha);
+    int perfilAPrioridad(const std::string &perfil) const;
+
+public:
+    ColaPorNiveles(int cap_inicial = 16);
+    ~ColaPorNiveles();
+    ColaPorNiveles(const ColaPorNiveles &) = delete;
+    ColaPorNiveles &operator=(const ColaPorNiveles &) = delete;
+
+    void insertar(long dni, const std::string &perfil, long ts);
+    // Inserta varios usuarios (prioridad ya calculada); cada uno es O(1)
+    void insertarLote(const Elemento *lote, int n);
+    Elemento extraerMax();
+    // Cambia la prioridad del DNI; false si no está en cola
+    bool actualizarPrioridadDni(long dni, int nuevaPrio);
+    bool eliminarPorDni(long dni);
+
+    Elemento *verTopK(int k, int &outCount) const;
+    Elemento *verTop5(int &outCount) const { return verTopK(5, outCount); }
+
+    bool estaVacio() const { return tamanio == 0; }
+
+    // No hay posiciones que exponer (MaxHeap::buscarIndice): solo si está
+    bool contiene(long dni) const { return vigentes.obtener(dni) >= 0; }
+
+    int perfilAPrioridadPublic(const std::string &perfil) const
+    {
+        return perfilAPrioridad(perfil);
+    }
+};
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef DARY_HEAP_H
+#define DARY_HEAP_H
+
+#include <new>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// Política por defecto: no hace falta saber dónde queda cada elemento
+struct SinSeguimiento
+{
+    template <typename T>
+    void operator()(const T &, int) const {}
+};
+
+// Heap d-ario genérico con aridad fija en compilación (2, 4, 8...).
+//  - T: elemento trivialmente copiable (idealmente 8 o 16 bytes)
+//  - D: hijos por nodo. Con D > 2 el árbol es más bajo: insertar (que sube)
+//    hace menos pasos, a cambio de comparar D hijos al bajar
+//  - Compare: mayor(a, b) es true si a debe quedar por encima de b
+//  - Movimiento: se llama con (elemento, posición) cada vez que un elemento
+//    se escribe en el arreglo; permite mantener un índice de posiciones
+// El arreglo se reserva alineado a línea de caché y desplazado para que los
+// D hermanos de cada nodo (posiciones D*i+1 .. D*i+D) compartan líneas.
+template <typename T, int D, typename Compare, typename Movimiento = SinSeguimiento>
+class DaryHeap
+{
+    static_assert(D >= 2, "la aridad debe ser al menos 2");
+    static_assert(std::is_trivially_copyable<T>::value, "T debe ser trivialmente copiable");
+
+public:
+    static const int LINEA_CACHE = 64;
+
+private:
+    void *bloque;    // memoria reservada (alineada)
+    T *datos;        // datos[0] es la raíz
+    int capacidad;
+    int tamanio;
+    Compare mayor;
+    Movimiento mover;
+
+    // Los hijos del nodo 0 empiezan en la posición 1: se corre el arreglo
+    // para que esa posición caiga al inicio de una línea
+    static size_t desplazamiento()
+    {
+        return (LINEA_CACHE % sizeof(T) == 0) ? LINEA_CACHE - sizeof(T) : 0;
+    }
+
+    void reservar(int nuevaCap)
+    {
+        void *nuevo = ::operator new(desplazamiento() + nuevaCap * sizeof(T),
+                                     std::align_val_t(LINEA_CACHE));
+        T *nuevosDatos = reinterpret_cast<T *>(static_cast<char *>(nuevo) + desplazamiento());
+        if (tamanio > 0)
+            std::memcpy(nuevosDatos, datos, tamanio * sizeof(T));
+        if (bloque)
+            ::operator delete(bloque, std::align_val_t(LINEA_CACHE));
+        bloque = nuevo;
+        datos = nuevosDatos;
+        capacidad = nuevaCap;
+    }
+
+    void colocar(int i, const T &e)
+    {
+        datos[i] = e;
+        mover(e, i);
+    }
+
+public:
+    static int padre(int i) { return (i - 1) / D; }
+    static int primerHijo(int i) { return D * i + 1; }
+
+    DaryHeap(int cap_inicial = 64, Compare cmp = Compare(), Movimiento mov = Movimiento())
+        : bloque(nullptr), datos(nullptr), capacidad(0), tamanio(0), mayor(cmp), mover(mov)
+    {
+        reservar(cap_inicial < 1 ? 1 : cap_inicial);
+    }
+
+    ~DaryHeap()
+    {
+        ::operator delete(bloque, std::align_val_t(LINEA_CACHE));
+    }
+
+    DaryHeap(const DaryHeap &) = delete;
+    DaryHeap &operator=(const DaryHeap &) = delete;
+
+    int getTamanio() const { return tamanio; }
+    bool estaVacio() const { return tamanio == 0; }
+    const T &en(int i) const { return datos[i]; }
+    T &en(int i) { return datos[i]; }
+    const T &tope() const { return datos[0]; }
+    bool esMayor(const T &a, const T &b) const { return mayor(a, b); }
+
+    // Sube el elemento de la posición i: los padres menores bajan al hueco
+    // y el elemento se escribe una sola vez al final
+    void subir(int i)
+    {
+        T e = datos[i];
+        while (i > 0)
+        {
+            int p = padre(i);
+            if (!mayor(e, datos[p]))
+                break;
+            colocar(i, datos[p]);
+            i = p;
+        }
+        colocar(i, e);
+    }
+
+    // Baja el elemento de la posición i eligiendo al mayor de sus D hijos
+    void bajar(int i)
+    {
+        T e = datos[i];
+        while (true)
+        {
+            int h = primerHijo(i);
+            if (h >= tamanio)
+                break;
+            int fin = h + D < tamanio ? h + D : tamanio;
+            int mejor = h;
+            for (int c = h + 1; c < fin; ++c)
+            {
+                if (mayor(datos[c], datos[mejor]))
+                    mejor = c;
+            }
+            if (!mayor(datos[mejor], e))
+                break;
+            colocar(i, datos[mejor]);
+            i = mejor;
+        }
+        colocar(i, e);
+    }
+
+    // Reubica el elemento de la posición i después de modificarlo
+    void reubicar(int i)
+    {
+        if (i > 0 && mayor(datos[i], datos[padre(i)]))
+            subir(i);
+        else
+            bajar(i);
+    }
+
+    void insertar(const T &e)
+    {
+        if (tamanio == capacidad)
+            reservar(capacidad * 2);
+        datos[tamanio] = e;
+        subir(tamanio++);
+    }
+
+    // Agrega al final sin reordenar; hay que llamar a reconstruir() después
+    void agregarSinOrden(const T &e)
+    {
+        if (tamanio == capacidad)
+            reservar(capacidad * 2);
+        colocar(tamanio++, e);
+    }
+
+    // Construcción de Floyd: baja cada nodo interno desde el último hasta la
+    // raíz. Restaura la propiedad de heap en O(n), sin importar el orden
+    void reconstruir()
+    {
+        if (tamanio < 2)
+            return;
+        for (int i = padre(tamanio - 1); i >= 0; --i)
+            bajar(i);
+    }
+
+    // Quita y devuelve la raíz (el heap no debe estar vacío)
+    T extraerTope()
+    {
+        T root = datos[0];
+        --tamanio;
+        if (tamanio > 0)
+        {
+            datos[0] = datos[tamanio];
+            bajar(0);
+        }
+        return root;
+    }
+
+    // Quita el elemento de la posición i; el último ocupa su lugar
+    void eliminarEn(int i)
+    {
+        --tamanio;
+        if (i < tamanio)
+        {
+            datos[i] = datos[tamanio];
+            reubicar(i);
+        }
+    }
+
+    // Copia en out los k mayores, en orden, sin modificar ni copiar el heap.
+    // Usa una frontera (heap binario auxiliar de posiciones) que empieza en
+    // la raíz: al sacar una posición se agregan sus D hijos. O(k·D·log k)
+    int verTopK(int k, T *out) const
+    {
+        int n = tamanio < k ? tamanio : k;
+        if (n <= 0)
+            return 0;
+        int *frontera = new int[n * D + 1];
+        int tamFrontera = 0;
+        frontera[tamFrontera++] = 0;
+
+        for (int i = 0; i < n; ++i)
+        {
+            int actual = frontera[0];
+            out[i] = datos[actual];
+            frontera[0] = frontera[--tamFrontera];
+            int j = 0;
+            while (true)
+            {
+                int m = j, l = 2 * j + 1, r = 2 * j + 2;
+                if (l < tamFrontera && mayor(datos[frontera[l]], datos[frontera[m]]))
+                    m = l;
+                if (r < tamFrontera && mayor(datos[frontera[r]], datos[frontera[m]]))
+                    m = r;
+                if (m == j)
+                    break;
+                int aux = frontera[j];
+                frontera[j] = frontera[m];
+                frontera[m] = aux;
+                j = m;
+            }
+
+            int h = primerHijo(actual);
+            for (int c = h; c < h + D && c < tamanio; ++c)
+            {
+                j = tamFrontera++;
+                frontera[j] = c;
+                while (j > 0 && mayor(datos[frontera[j]], datos[frontera[(j - 1) / 2]]))
+                {
+                    int aux = frontera[j];
+                    frontera[j] = frontera[(j - 1) / 2];
+                    frontera[(j - 1) / 2] = aux;
+                    j = (j - 1) / 2;
+                }
+            }
+        }
+        delete[] frontera;
+        return n;
+    }
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef EPOCAS_H
+#define EPOCAS_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Reclamación por épocas (EBR) para estructuras con lecturas sin lock.
+// Un lector entra a una sección crítica (GuardaEpoca) anunciando la época
+// global; mientras dura puede seguir punteros que un escritor ya
+// desenganchó. El escritor no libera esos objetos: los retira, y se liberan
+// cuando la época global avanzó dos veces, porque para entonces ningún
+// lector que pudiera haberlos visto sigue activo.
+class DominioEpocas
+{
+public:
+    // Un registro por hilo lector, en su propia línea de caché. Los
+    // registros no se liberan nunca: cuando un hilo termina queda libre
+    // para el siguiente
+    struct alignas(64) RegistroHilo
+    {
+        std::atomic<uint64_t> anuncio; // (época << 1) | 1 si está activo, 0 si no
+        std::atomic<bool> enUso;
+        int anidamiento;               // solo lo toca su hilo
+        RegistroHilo *siguiente;
+    };
+
+private:
+    struct Retirado
+    {
+        void *ptr;
+        void (*liberar)(void *);
+        uint64_t epoca;
+    };
+
+    std::atomic<uint64_t> epoca;
+    std::atomic<RegistroHilo *> registros; // lista sin locks, solo crece
+    std::mutex mutexRetirados;              // solo lo toman escritores
+    std::vector<Retirado> retirados;
+
+    DominioEpocas();
+    ~DominioEpocas();
+
+    // Avanza la época si todos los lectores activos ya vieron la actual
+    bool intentarAvanzar();
+
+public:
+    DominioEpocas(const DominioEpocas &) = delete;
+    DominioEpocas &operator=(const DominioEpocas &) = delete;
+
+    // Dominio único del proceso: cada hilo tiene un solo registro
+    static DominioEpocas &global();
+
+    RegistroHilo *registroDelHilo();
+    void entrar(RegistroHilo *r);
+    void salir(RegistroHilo *r);
+
+    // Difiere la liberación de p hasta que ningún lector pueda verlo.
+    // Llamar después de desenganchar p de la estructura
+    void retirar(void *p, void (*liberar)(void *));
+
+    template <typename T>
+    void retirar(T *p)
+    {
+        retirar(static_cast<void *>(p), [](void *q)
+                { delete static_cast<T *>(q); });
+    }
+
+    // Libera lo retirado hace al menos dos épocas; devuelve cuántos liberó
+    int recolectar();
+    int getPendientes();
+};
+
+// Sección crítica de lectura (RAII). Se puede anidar
+class GuardaEpoca
+{
+private:
+    DominioEpocas::RegistroHilo *registro;
+
+public:
+    GuardaEpoca()
+        : registro(DominioEpocas::global().registroDelHilo())
+    {
+        DominioEpocas::global().entrar(registro);
+    }
+    ~GuardaEpoca() { DominioEpocas::global().salir(registro); }
+    GuardaEpoca(const GuardaEpoca &) = delete;
+    GuardaEpoca &operator=(const GuardaEpoca &) = delete;
+};
+
+#endif
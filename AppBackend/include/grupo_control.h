@@ -0,0 +1,47 @@
+#ifndef GRUPO_CONTROL_H
+#define GRUPO_CONTROL_H
+
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Bytes de control de las tablas de direccionamiento abierto (TablaHash y
+// TablaHashConcurrente), sondeados de a grupos de 16 slots.
+// Un slot libre vale VACIO; uno ocupado guarda 0x80 | h2, así una tabla
+// nueva sale de calloc ya vacía, sin recorrerla con memset
+static const int SLOTS_POR_GRUPO = 16;
+static const uint8_t VACIO = 0x00;
+static const uint8_t OCUPADO = 0x80;
+
+// Máscara de slots del grupo cuyo byte de control coincide con h2
+static inline unsigned coincidencias(const uint8_t *grupo, uint8_t h2)
+{
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(grupo));
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(h2)))));
+#else
+    unsigned m = 0;
+    for (int i = 0; i < SLOTS_POR_GRUPO; ++i)
+        if (grupo[i] == h2)
+            m |= 1u << i;
+    return m;
+#endif
+}
+
+// Máscara de slots vacíos del grupo
+static inline unsigned vacios(const uint8_t *grupo)
+{
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(grupo));
+    return static_cast<unsigned>(_mm_movemask_epi8(ctrl)) ^ 0xFFFFu;
+#else
+    unsigned m = 0;
+    for (int i = 0; i < SLOTS_POR_GRUPO; ++i)
+        if (grupo[i] == VACIO)
+            m |= 1u << i;
+    return m;
+#endif
+}
+
+#endif
@@ -2,43 +2,106 @@
 #define HASH_TABLE_H
 
 #include <string>
+#include <cstdint>
+#include <vector>
 
-// Nodo para encadenamiento de colisiones, conteo de zonas y estado de servicio
+// Registro de usuario y su estado de servicio
 struct NodoHash
 {
     long dni;
     std::string perfil;
-    int contador;  // contador gen�rico: para conteo de zonas
-    bool enCola;   // true si est� actualmente en la cola de prioridad
-    bool atendido; // true si ya fue extra�do de la cola alguna vez
-    NodoHash *siguiente;
+    bool enCola;   // true si está actualmente en la cola de prioridad
+    bool atendido; // true si ya fue extraído de la cola alguna vez
+    int posPendiente; // posición en el índice de pendientes, -1 si no está
+
+    NodoHash()
+        : dni(0),
+          enCola(false),
+          atendido(false),
+          posPendiente(-1)
+    {
+    }
 
     NodoHash(long _dni, const std::string &_perfil)
         : dni(_dni),
           perfil(_perfil),
-          contador(0),
           enCola(false),
           atendido(false),
-          siguiente(nullptr)
+          posPendiente(-1)
     {
     }
+
+    // Registrado pero todavía sin encolar ni atender
+    bool pendiente() const { return !enCola && !atendido; }
+};
+
+// Slot de la tabla: DNI y posición de su registro en el almacén por bloques
+struct SlotHash
+{
+    long dni;
+    int id;
 };
 
+// Tabla hash de direccionamiento abierto:
+//  - control: un byte por slot, VACIO o 0x80 | los 7 bits bajos del hash
+//  - slots:   DNIs (e id del registro) en un arreglo plano, se comparan
+//             sin seguir punteros
+// Se sondea de a grupos de 16 slots comparando los bytes de control con SSE2.
+// No existe borrado, por eso el crecimiento nunca deja lápidas (tombstones).
+// El crecimiento es incremental: cada operación que modifica la tabla migra
+// unos pocos grupos del arreglo viejo al nuevo, y mientras dura la migración
+// las búsquedas consultan ambos arreglos.
 class TablaHash
 {
+public:
+    static const int TAM_GRUPO = 16;        // slots sondeados a la vez
+    static const int TAM_BLOQUE = 1024;     // registros por bloque del almacén
+    static const int GRUPOS_POR_PASO = 4;   // grupos migrados por operación
+
 private:
-    NodoHash **tabla;  // arreglo de punteros a NodoHash
-    int tam;           // tamaño actual de la tabla
+    uint8_t *control;  // metadatos por slot
+    SlotHash *slots;   // DNI e id de registro de cada slot ocupado
+    int tam;           // número de slots (potencia de dos, múltiplo de 16)
     int usados;        // numero de elementos almacenados
     float cargaMaxima; // umbral para rehashing
 
+    // Almacén de registros: los punteros a NodoHash siguen siendo válidos
+    // aunque la tabla crezca, porque la migración solo copia DNIs e ids
+    NodoHash **bloques;
+    int numBloques;
+    int capBloques;
+
+    // Arreglos anteriores mientras hay una migración en curso (nullptr si no)
+    uint8_t *viejoControl;
+    SlotHash *viejosSlots;
+    int viejoTam;
+    int gruposMigrados; // grupos del arreglo viejo ya copiados al nuevo
+
+    // Índice de pendientes: conjunto denso de ids. Cada NodoHash guarda su
+    // posición, así agregar y quitar (intercambiando con el último) es O(1)
+    std::vector<int> pendientes;
+
+    // Inicia el crecimiento: reserva el arreglo nuevo y deja el viejo pendiente
     void rehash();
-    int hashFunc(long clave) const;
+    // Migra hasta GRUPOS_POR_PASO grupos; libera el arreglo viejo al terminar
+    void migrarPaso();
 
-    // Busca un nodo por su perfil (clave), sin usar dni
-    NodoHash *buscarPorPerfil(const std::string &perfil) const;
+    // Devuelve el id del registro con ese DNI en los arreglos dados, o -1
+    static int buscarEn(const uint8_t *ctrl, const SlotHash *sl, int n, long dni);
+    // Devuelve el id del registro con ese DNI (arreglo nuevo y viejo), o -1
+    int buscarId(long dni) const;
+    // Ubica un DNI en el primer slot vacío de su secuencia de sondeo
+    static void colocarEn(uint8_t *ctrl, SlotHash *sl, int n, long dni, int id);
+    // Reserva un registro nuevo en el almacén y devuelve su id
+    int nuevoRegistro(long dni, const std::string &perfil);
+    // Agrega o quita el registro del índice según su estado actual
+    void actualizarPendiente(int id);
 
 public:
+    // Usa los bits bajos para ubicar el slot; TablaHashConcurrente elige el
+    // fragmento con los altos
+    static uint64_t hashFunc(long clave);
+
     TablaHash(int tamano_inicial = 17, float carga_maxima = 0.7f);
     ~TablaHash();
 
@@ -51,13 +114,17 @@ public:
     void marcarEnCola(long dni, bool estado);
     void marcarAtendido(long dni, bool estado);
 
-    // Métodos de conteo que usan el perfil como clave y se usa en avl
-    void incrementar(const std::string &clave);
-    int obtenerConteo(const std::string &clave) const;
-
-    // Acceso a buckets para iteracion externa
+    // Acceso a registros para iteración externa (ids densos 0..getCantidad()-1)
     int getTam() const { return tam; }
-    NodoHash *getBucket(int idx) const { return tabla[idx]; }
+    bool migrando() const { return viejoControl != nullptr; }
+    int getCantidad() const { return usados; }
+    NodoHash *getUsuario(int id) const { return &bloques[id / TAM_BLOQUE][id % TAM_BLOQUE]; }
+
+    // Pendientes sin recorrer la tabla (i en 0..getCantidadPendientes()-1,
+    // sin orden particular). El estado solo debe cambiarse con marcarEnCola
+    // y marcarAtendido para que el índice quede al día
+    int getCantidadPendientes() const { return static_cast<int>(pendientes.size()); }
+    NodoHash *getPendiente(int i) const { return getUsuario(pendientes[i]); }
 };
 
 #endif
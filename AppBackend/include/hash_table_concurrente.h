@@ -0,0 +1,248 @@
+#ifndef HASH_TABLE_CONCURRENTE_H
+#define HASH_TABLE_CONCURRENTE_H
+
+#include "epocas.h"
+#include "indice_bitmap.h"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+// Estados de un usuario para los filtros
+enum EstadoUsuario
+{
+    ESTADO_PENDIENTE = 0,
+    ESTADO_EN_COLA = 1,
+    ESTADO_ATENDIDO = 2,
+    NUM_ESTADOS = 3
+};
+
+// Registro de usuario compartido entre hilos. El DNI no cambia después de
+// publicado; el perfil es inmutable y se reemplaza entero (el viejo se
+// retira por épocas), y los estados son atómicos
+struct RegistroUsuario
+{
+    long dni;
+    uint32_t id; // id global denso: (id en el fragmento << bits) | fragmento
+    std::atomic<const std::string *> perfil;
+    std::atomic<bool> enCola;
+    std::atomic<bool> atendido;
+    int posPendiente; // en el índice de pendientes del fragmento, -1 si no está
+
+    RegistroUsuario()
+        : dni(0), id(0), perfil(nullptr), enCola(false), atendido(false), posPendiente(-1)
+    {
+    }
+
+    bool pendiente() const { return !enCola.load() && !atendido.load(); }
+    EstadoUsuario estado() const
+    {
+        return atendido.load() ? ESTADO_ATENDIDO : enCola.load() ? ESTADO_EN_COLA : ESTADO_PENDIENTE;
+    }
+
+    // Copia del perfil actual. Llamar desde leer, modificar o recorrer:
+    // fuera de ellos el perfil puede liberarse mientras se copia
+    std::string getPerfil() const { return *perfil.load(std::memory_order_acquire); }
+};
+
+// Tabla hash para varios hilos con lecturas sin lock:
+//  - N fragmentos (potencia de dos), elegidos con los bits altos del hash.
+//    Los escritores de un mismo fragmento se serializan con su mutex; los de
+//    fragmentos distintos avanzan en paralelo
+//  - Las búsquedas no toman ningún lock: leen el arreglo vigente del
+//    fragmento y el byte de control de cada slot con acquire. El escritor
+//    completa el slot antes de publicar su byte de control con release
+//  - Crecer es incremental, como en TablaHash: el arreglo nuevo se publica
+//    con un solo store atómico y apunta al viejo, que queda de solo
+//    lectura. Cada inserción migra GRUPOS_POR_PASO grupos y, mientras dura
+//    la migración, las búsquedas que no encuentran en el nuevo miran el
+//    viejo. Al terminar se desengancha el viejo y se libera por épocas,
+//    igual que los perfiles reemplazados
+//  - Los registros viven en bloques que no se mueven ni se liberan
+class TablaHashConcurrente
+{
+public:
+    static const int FRAGMENTOS_POR_DEFECTO = 16;
+    static const int TAM_BLOQUE = 1024;     // registros por bloque
+    static const int MAX_BLOQUES = 4096;    // por fragmento
+    static const int GRUPOS_POR_PASO = 4;   // grupos migrados por inserción
+
+private:
+    struct SlotConcurrente
+    {
+        long dni;
+        RegistroUsuario *registro;
+    };
+
+    struct ArregloHash
+    {
+        int tam;              // potencia de dos, múltiplo de 16
+        uint8_t *control;     // VACIO o 0x80 | h2, como en TablaHash
+        SlotConcurrente *slots;
+        // Arreglo anterior mientras se migra (nullptr si no). Los lectores
+        // lo leen antes de buscar en este: si ya es nullptr, todo lo migrado
+        // está visible aquí
+        std::atomic<ArregloHash *> anterior;
+
+        explicit ArregloHash(int n);
+        ~ArregloHash();
+    };
+
+    struct alignas(64) Fragmento
+    {
+        std::mutex escritura;
+        std::atomic<ArregloHash *> arreglo;
+        int usados; // solo lo toca el escritor
+        int gruposMigrados; // del arreglo anterior; solo lo toca el escritor
+        std::atomic<int> cantidad; // registros publicados (para recorrer)
+        std::atomic<RegistroUsuario *> bloques[MAX_BLOQUES];
+        // Registrados sin encolar ni atender, como conjunto denso (quitar
+        // intercambia con el último). Protegido por el mutex de escritura
+        std::vector<RegistroUsuario *> pendientes;
+        std::atomic<int> numPendientes;
+
+        Fragmento();
+        ~Fragmento();
+    };
+
+    Fragmento *fragmentos;
+    int numFragmentos;
+    int bitsFragmento;
+    float cargaMaxima;
+
+    // Filtros por estado y por perfil sobre los ids globales. Los escritores
+    // los actualizan con el mutex de su fragmento ya tomado (siempre en ese
+    // orden); las consultas solo toman mutexFiltros en modo compartido
+    mutable std::shared_mutex mutexFiltros;
+    IndiceBitmap porEstado[NUM_ESTADOS];
+    std::map<std::string, IndiceBitmap> porPerfil;
+
+    Fragmento &fragmentoDe(long dni) const;
+    static RegistroUsuario *buscarEn(const ArregloHash *a, long dni);
+    // Busca en el arreglo y, si hay migración en curso, en el anterior
+    static RegistroUsuario *buscarEnArreglos(const ArregloHash *a, long dni);
+    static void colocarEn(ArregloHash *a, long dni, RegistroUsuario *r);
+    // Con el mutex del fragmento tomado
+    void crecer(Fragmento &fr);
+    // Migra hasta GRUPOS_POR_PASO grupos del arreglo anterior; al terminar
+    // lo desengancha y lo retira. Con el mutex del fragmento tomado
+    static void migrarPaso(Fragmento &fr);
+    static void actualizarPendiente(Fragmento &fr, RegistroUsuario *r);
+    // Mueve el id entre los filtros si cambió el estado o el perfil
+    void actualizarFiltros(const RegistroUsuario *r, EstadoUsuario estadoAntes,
+                           const std::string *perfilAntes);
+    const RegistroUsuario *registroPorId(uint32_t id) const;
+    // Ids de la página pedida (ver listar); perfil nullptr = cualquiera
+    long listarIds(EstadoUsuario estado, const std::string *perfil, uint32_t desde,
+                   int limite, std::vector<uint32_t> &ids) const;
+    RegistroUsuario *buscarRegistro(long dni) const;
+
+public:
+    explicit TablaHashConcurrente(int num_fragmentos = FRAGMENTOS_POR_DEFECTO,
+                                  float carga_maxima = 0.7f);
+    ~TablaHashConcurrente();
+    TablaHashConcurrente(const TablaHashConcurrente &) = delete;
+    TablaHashConcurrente &operator=(const TablaHashConcurrente &) = delete;
+
+    // Inserta si el DNI no existe. Devuelve false si ya estaba registrado
+    bool insertar(long dni, const std::string &perfil);
+    // Sin locks
+    bool validar(long dni) const;
+    bool obtenerPerfil(long dni, std::string &perfil) const;
+
+    // Reemplaza el perfil; devuelve false si el DNI no existe
+    bool cambiarPerfil(long dni, const std::string &perfil);
+    void marcarEnCola(long dni, bool estado);
+    void marcarAtendido(long dni, bool estado);
+
+    // Aplica f(const RegistroUsuario &) sin locks. Devuelve false (sin
+    // llamar a f) si el DNI no existe
+    template <typename F>
+    bool leer(long dni, F f) const
+    {
+        GuardaEpoca guarda;
+        RegistroUsuario *r = buscarRegistro(dni);
+        if (!r)
+            return false;
+        f(static_cast<const RegistroUsuario &>(*r));
+        return true;
+    }
+
+    // Aplica f(RegistroUsuario &) con el mutex de escritura del fragmento,
+    // así una comprobación y un cambio de estado no se intercalan con otro
+    // escritor. Los lectores pueden ver cada campo antes o después del cambio
+    template <typename F>
+    bool modificar(long dni, F f)
+    {
+        Fragmento &fr = fragmentoDe(dni);
+        std::lock_guard<std::mutex> lk(fr.escritura);
+        // El perfil anterior se compara después de f, que puede retirarlo
+        GuardaEpoca guarda;
+        RegistroUsuario *r = buscarEnArreglos(fr.arreglo.load(std::memory_order_relaxed), dni);
+        if (!r)
+            return false;
+        EstadoUsuario estadoAntes = r->estado();
+        const std::string *perfilAntes = r->perfil.load(std::memory_order_relaxed);
+        f(*r);
+        actualizarPendiente(fr, r);
+        actualizarFiltros(r, estadoAntes, perfilAntes);
+        return true;
+    }
+
+    // Recorre los registros publicados sin locks, fragmento por fragmento.
+    // Dentro de un fragmento el orden es el de inserción
+    template <typename F>
+    void recorrer(F f) const
+    {
+        GuardaEpoca guarda;
+        for (int i = 0; i < numFragmentos; ++i)
+        {
+            const Fragmento &fr = fragmentos[i];
+            int n = fr.cantidad.load(std::memory_order_acquire);
+            for (int id = 0; id < n; ++id)
+            {
+                const RegistroUsuario *b = fr.bloques[id / TAM_BLOQUE].load(std::memory_order_relaxed);
+                f(b[id % TAM_BLOQUE]);
+            }
+        }
+    }
+
+    // Solo los pendientes: O(resultado), tomando de a un mutex de fragmento.
+    // Sin orden particular
+    template <typename F>
+    void recorrerPendientes(F f) const
+    {
+        for (int i = 0; i < numFragmentos; ++i)
+        {
+            std::lock_guard<std::mutex> lk(fragmentos[i].escritura);
+            for (const RegistroUsuario *r : fragmentos[i].pendientes)
+                f(*r);
+        }
+    }
+
+    // Página de usuarios con ese estado (y perfil, si no es nullptr) en orden
+    // de id global, desde el id "desde" y hasta "limite" usuarios. El costo
+    // depende de la página, no de cuántos usuarios hay. Devuelve el id con
+    // el que empieza la página siguiente, o -1 si no hay más
+    template <typename F>
+    long listar(EstadoUsuario estado, const std::string *perfil, uint32_t desde, int limite, F f) const
+    {
+        std::vector<uint32_t> ids;
+        long siguiente = listarIds(estado, perfil, desde, limite, ids);
+        GuardaEpoca guarda;
+        for (uint32_t id : ids)
+            f(*registroPorId(id));
+        return siguiente;
+    }
+
+    int getCantidad() const;
+    int getCantidadPendientes() const;
+    int getNumFragmentos() const { return numFragmentos; }
+    // Algún fragmento tiene una migración en curso
+    bool migrando() const;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef HASH_TABLE_ENCADENADA_H
+#define HASH_TABLE_ENCADENADA_H
+
+#include <string>
+
+// Implementación original con encadenamiento (un nodo por usuario).
+// Se conserva solo como referencia para la prueba técnica comparativa.
+struct NodoEncadenado
+{
+    long dni;
+    std::string perfil;
+    bool enCola;
+    bool atendido;
+    NodoEncadenado *siguiente;
+
+    NodoEncadenado(long _dni, const std::string &_perfil)
+        : dni(_dni),
+          perfil(_perfil),
+          enCola(false),
+          atendido(false),
+          siguiente(nullptr)
+    {
+    }
+};
+
+class TablaHashEncadenada
+{
+private:
+    NodoEncadenado **tabla; // arreglo de punteros a NodoEncadenado
+    int tam;                // tamaño actual de la tabla
+    int usados;             // numero de elementos almacenados
+    float cargaMaxima;      // umbral para rehashing
+
+    void rehash();
+    int hashFunc(long clave) const;
+
+public:
+    TablaHashEncadenada(int tamano_inicial = 17, float carga_maxima = 0.7f);
+    ~TablaHashEncadenada();
+
+    void insertar(long dni, const std::string &perfil);
+    NodoEncadenado *buscar(long dni) const;
+    bool validar(long dni) const;
+
+    void marcarEnCola(long dni, bool estado);
+    void marcarAtendido(long dni, bool estado);
+};
+
+#endif
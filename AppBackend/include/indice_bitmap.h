@@ -0,0 +1,64 @@
+#ifndef INDICE_BITMAP_H
+#define INDICE_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Conjunto de ids de 32 bits comprimido al estilo roaring: los ids se
+// agrupan por sus 16 bits altos y cada grupo (contenedor) guarda los 16
+// bits bajos como
+//  - arreglo ordenado de uint16_t mientras tenga pocos elementos, o
+//  - mapa de bits de 65536 bits (1024 palabras) cuando se llena.
+// Así un perfil raro ocupa poco y uno masivo se intersecta palabra a
+// palabra (con SSE2, de a dos palabras).
+class IndiceBitmap
+{
+public:
+    static const int PALABRAS_MAPA = 1024;
+    static const int MAX_ARREGLO = 4096; // más elementos: pasa a mapa
+    static const int MIN_MAPA = 2048;    // menos elementos: vuelve a arreglo
+
+private:
+    struct Contenedor
+    {
+        uint16_t clave; // 16 bits altos de los ids
+        int cardinalidad;
+        std::vector<uint16_t> arreglo; // ordenado; vacío si es mapa
+        std::vector<uint64_t> mapa;    // PALABRAS_MAPA palabras, o vacío
+
+        bool esMapa() const { return !mapa.empty(); }
+        bool contiene(uint16_t bajo) const;
+        void aMapa();
+        void aArreglo();
+    };
+
+    std::vector<Contenedor> contenedores; // ordenados por clave
+    long cardinalidad;
+
+    // Posición del contenedor con esa clave, o -1
+    int buscarContenedor(uint16_t clave) const;
+    // Primer contenedor con clave >= la dada
+    int primerContenedorDesde(uint16_t clave) const;
+
+    // Intersecta un contenedor de cada conjunto (misma clave) desde el id
+    // bajo "inicio". Agrega a out hasta que tenga "tope" elementos
+    static void intersectarContenedores(const Contenedor *const *cs, int n, uint32_t inicio,
+                                        std::vector<uint32_t> &out, size_t tope);
+
+public:
+    IndiceBitmap();
+
+    void agregar(uint32_t id);
+    void quitar(uint32_t id);
+    bool contiene(uint32_t id) const;
+    long getCardinalidad() const { return cardinalidad; }
+
+    // Ids presentes en los n conjuntos, en orden creciente, a partir de
+    // "desde" y hasta "limite" elementos. Devuelve el id con el que empieza
+    // la página siguiente, o -1 si no quedan más
+    static long interseccion(const IndiceBitmap *const *conjuntos, int n, uint32_t desde,
+                             int limite, std::vector<uint32_t> &out);
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef INDICE_DNI_H
+#define INDICE_DNI_H
+
+// Mapa DNI -> posición (entero) con direccionamiento abierto y sondeo lineal.
+// Lo usa MaxHeap para ubicar a un usuario en el heap en O(1).
+// El borrado desplaza hacia atrás los elementos siguientes del grupo
+// (backward shift), así no quedan lápidas que alarguen los sondeos.
+class IndiceDni
+{
+private:
+    long *claves; // DNI de cada slot, VACIO si está libre
+    int *valores; // posición asociada a cada DNI
+    int tam;      // potencia de dos
+    int usados;
+
+    int slotIdeal(long dni) const;
+    void crecer();
+
+public:
+    IndiceDni(int tamano_inicial = 64);
+    ~IndiceDni();
+    IndiceDni(const IndiceDni &) = delete;
+    IndiceDni &operator=(const IndiceDni &) = delete;
+
+    // Asigna (o reemplaza) la posición de un DNI
+    void asignar(long dni, int pos);
+    // Devuelve la posición del DNI, o -1 si no está
+    int obtener(long dni) const;
+    // Quita el DNI del índice (no hace nada si no está)
+    void eliminar(long dni);
+    // Vacía el índice conservando la capacidad
+    void limpiar();
+
+    int getCantidad() const { return usados; }
+};
+
+#endif
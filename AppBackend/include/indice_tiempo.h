@@ -0,0 +1,150 @@
+#ifndef INDICE_TIEMPO_H
+#define INDICE_TIEMPO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "avl_tree.h"
+#include "ranking_conteo.h"
+
+// Un acceso en el índice: clave (timestamp, secuencia) y zona por id
+struct Acceso
+{
+    long timestamp;
+    long secuencia;
+    int zonaId; // id en RegistroZonas
+};
+
+class IndiceTiempo;
+
+// Recorrido en orden que mezcla el segmento ordenado con los rezagados
+class IteradorTiempo
+{
+private:
+    const IndiceTiempo *indice;
+    long pos;        // siguiente posición del segmento
+    IteradorAVL rez; // siguiente rezagado
+    bool enSegmento; // de dónde salió el actual
+    Acceso actual;
+
+    void elegir();
+
+public:
+    IteradorTiempo() : indice(nullptr), pos(0), enSegmento(false), actual{0, 0, 0} {}
+    IteradorTiempo(const IndiceTiempo *ind, long p, IteradorAVL r);
+    bool valido() const { return indice != nullptr; }
+    const Acceso &operator*() const { return actual; }
+    const Acceso *operator->() const { return &actual; }
+    IteradorTiempo &operator++();
+};
+
+// Índice de accesos por tiempo pensado para llegadas casi ordenadas:
+//  - Segmento ordenado: un acceso con timestamp >= al último se agrega al
+//    final en O(1), en bloques de TAM_BLOQUE que no se mueven. Cada bloque
+//    guarda los campos en columnas (timestamps, secuencias, zonas: 14 bytes
+//    por acceso) y un directorio aparte tiene el mínimo y máximo timestamp
+//    de cada bloque, así las búsquedas solo tocan los bloques del borde
+//  - Rezagados: los que llegan fuera de orden van a un ArbolAVL chico.
+//    Cuando junta MAX_REZAGADOS se mezcla con el segmento, reescribiendo
+//    solo desde la posición del rezagado más viejo, y sus nodos vuelven al
+//    pool para los próximos rezagados
+// Las consultas recorren y cuentan las dos partes. La secuencia es global,
+// así que la clave (timestamp, secuencia) es única entre ambas
+class IndiceTiempo
+{
+public:
+    static const int TAM_BLOQUE = 4096;
+    static const int MAX_REZAGADOS = 4096;
+
+private:
+    // Los ids de zona locales entran en 16 bits (RegistroZonas::MAX_ZONAS) y
+    // la secuencia en 32 (4 mil millones de accesos por índice)
+    struct BloqueAccesos
+    {
+        int64_t ts[TAM_BLOQUE];
+        uint32_t seq[TAM_BLOQUE];
+        uint16_t zona[TAM_BLOQUE];
+    };
+
+    std::vector<BloqueAccesos *> bloques; // no se liberan al truncar
+    std::vector<int64_t> minBloque;        // primer timestamp de cada bloque
+    std::vector<int64_t> maxBloque;        // último timestamp de cada bloque
+    long cantidadSegmento;
+    // prefijoZonas[b]: accesos por zona en los bloques anteriores al b
+    std::vector<std::vector<long>> prefijoZonas;
+    std::vector<long> conteoSegmento; // accesos por zona en todo el segmento
+    ArbolAVL *rezagados;
+    long siguienteSecuencia;
+    // Adentro del índice las zonas tienen ids locales, densos en orden de
+    // aparición: los conteos por zona (prefijos de bloque, nodos de los
+    // rezagados) crecen con las zonas de este índice, no con el mayor id
+    // registrado en el proceso. Lo que sale del índice usa ids globales
+    std::vector<int> zonaGlobal;            // id local -> id en RegistroZonas
+    std::unordered_map<int, int> zonaLocal; // id en RegistroZonas -> id local
+    RankingConteo conteoZonas;              // accesos por id local de las dos partes
+
+    friend class IteradorTiempo;
+
+    Acceso enSegmento(long i) const
+    {
+        const BloqueAccesos *b = bloques[i / TAM_BLOQUE];
+        int j = static_cast<int>(i % TAM_BLOQUE);
+        return {b->ts[j], b->seq[j], b->zona[j]};
+    }
+    // La clave de la posición i es <= (ts, seq)
+    bool claveHasta(long i, long ts, long seq) const;
+    int idLocal(int zonaId);
+    // Agrega al final del segmento sin comparar; el llamador garantiza el orden
+    void agregarAlFinal(const Acceso &a);
+    // Accesos del segmento con clave <= (ts, seq). O(log n)
+    long posicionSegmento(long ts, long seq) const;
+    // Suma en acum, por zona, los primeros n accesos del segmento
+    void contarZonasSegmento(long n, std::vector<long> &acum, long signo) const;
+    // Histograma de una columna de zonas (SIMD con pocas zonas)
+    static void contarZonasColumna(const uint16_t *zonas, int n, int numZonas,
+                                   std::vector<long> &acum, long signo);
+    void mezclarRezagados();
+
+public:
+    // Pool para los nodos de los rezagados (ver ArbolAVL)
+    explicit IndiceTiempo(PoolNodos<NodoAVL> *poolRezagados = nullptr);
+    ~IndiceTiempo();
+    IndiceTiempo(const IndiceTiempo &) = delete;
+    IndiceTiempo &operator=(const IndiceTiempo &) = delete;
+
+    // Registra la zona en RegistroZonas y la inserta por id (nada si el
+    // registro de zonas está lleno)
+    void insertar(const std::string &zona, long timestamp);
+    void insertar(int zonaId, long timestamp);
+
+    // Primer acceso con clave posterior a (ts, seq); ver ArbolAVL::desde
+    IteradorTiempo desde(long ts, long seq) const;
+    // Ver ArbolAVL::rangoPagina
+    bool rangoPagina(long desdeTs, long desdeSeq, long fin, int limite,
+                     std::vector<Acceso> &out) const;
+    long contarHasta(long ts, long seq) const;
+    long contarRango(long inicio, long fin) const;
+    // El k-ésimo acceso en orden de tiempo (desde 0). O(log² n)
+    bool seleccionar(long k, Acceso &out) const;
+    long getCantidad() const { return cantidadSegmento + rezagados->getCantidad(); }
+    long getCantidadRezagados() const { return rezagados->getCantidad(); }
+    // Bytes que ocupan los accesos (bloques, directorio, prefijos y rezagados)
+    size_t getMemoria() const;
+
+    const std::string &nombreZona(int zonaId) const;
+    // Zonas del índice por id local (0..getCantidadZonas()-1), para sumar
+    // conteos sin vectores del tamaño del registro global
+    int getCantidadZonas() const { return static_cast<int>(zonaGlobal.size()); }
+    int zonaGlobalDe(int local) const { return zonaGlobal[local]; }
+    long conteoZonaLocal(int local) const { return conteoZonas.getConteo(local); }
+    std::vector<long> conteoZonasLocalesEnRango(long inicio, long fin) const;
+    // Por id global (hasta el mayor id de este índice)
+    std::vector<long> conteoZonasEnRango(long inicio, long fin) const;
+    std::string zonaMasEntradas() const;
+    std::string zonaMasEntradas(long inicio, long fin) const;
+    std::vector<std::pair<std::string, long>> zonasTop(int k) const;
+};
+
+#endif
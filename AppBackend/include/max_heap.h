@@ -3,6 +3,9 @@
 #define MAX_HEAP_H
 
 #include <string>
+#include <cstdint>
+#include "indice_dni.h"
+#include "dary_heap.h"
 
 //  Elemento : Usuario Registrados
 struct Elemento
@@ -12,49 +15,94 @@ struct Elemento
     long ts; // Timestamp de cuándo fue encolado
 };
 
+// Entrada interna del heap: prioridad en los 32 bits altos de la clave y el
+// timestamp invertido en los 32 bajos. Así una sola comparación de enteros
+// ordena por prioridad y, a igual prioridad, primero al que llegó antes.
+struct EntradaHeap
+{
+    uint64_t clave;
+    long dni;
+};
+
+// Mayor timestamp que entra en la clave (segundos hasta el año 2106); los
+// puntos de entrada rechazan los mayores, por ejemplo en milisegundos
+static const long TS_MAXIMO_CLAVE = 0xFFFFFFFFL;
+
+inline uint64_t empaquetarClave(int prioridad, long ts)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(prioridad)) << 32) |
+           (0xFFFFFFFFu - static_cast<uint32_t>(ts));
+}
+
+inline Elemento desempaquetar(const EntradaHeap &e)
+{
+    Elemento out;
+    out.dni = e.dni;
+    out.prioridad = static_cast<int>(e.clave >> 32);
+    out.ts = static_cast<long>(0xFFFFFFFFu - static_cast<uint32_t>(e.clave));
+    return out;
+}
+
+// Orden del heap: clave empaquetada mayor primero
+struct MayorClave
+{
+    bool operator()(const EntradaHeap &a, const EntradaHeap &b) const { return a.clave > b.clave; }
+};
+
+// Registra en el índice la posición de cada entrada que se mueve
+struct RegistrarPosicion
+{
+    IndiceDni *indice;
+    void operator()(const EntradaHeap &e, int pos) const { indice->asignar(e.dni, pos); }
+};
+
+// Aridad del heap de la cola (2, 4 u 8); ver compararAridades() en main
+#ifndef MAX_HEAP_ARIDAD
+#define MAX_HEAP_ARIDAD 4
+#endif
+
 class MaxHeap
 {
 private:
-    Elemento *heap; // Array dinámico que soporta la estructura de heap
-    int capacidad;  // Capacidad actual del array
-    int tamanio;    // Número de elementos en el heap
-
-    // logica de PROPIEDADES
-    int padre(int i) const { return (i - 1) / 2; }
-    int izq(int i) const { return 2 * i + 1; }
-    int der(int i) const { return 2 * i + 2; }
-
-    // Reorganiza hacia abajo para mantener la propiedad de max-heap al sacar la cabeza
-    void heapifyDown(int i);
-    // Reorganiza hacia arriba tras insertar un nuevo elemento
-    void heapifyUp(int i);
-    // Duplica la capacidad del array cuando está lleno
-    void expandir();
+    IndiceDni posiciones; // DNI -> índice en heap, se actualiza en cada movimiento
+    // Heap d-ario que soporta la cola; MaxHeap solo traduce perfiles y DNIs
+    DaryHeap<EntradaHeap, MAX_HEAP_ARIDAD, MayorClave, RegistrarPosicion> heap;
+
     // Convierte un string de perfil a un valor numérico de prioridad
     int perfilAPrioridad(const std::string &perfil) const;
 
 public:
     // Constructor: inicializa con capacidad por defecto (100)
     MaxHeap(int cap_inicial = 100);
-    // Destructor: libera la memoria dinámica
-    ~MaxHeap();
 
     // Inserta un nuevo usuario en la cola, usando perfil→prioridad
     void insertar(long dni, const std::string &perfil, long ts);
+    // Inserta varios usuarios (prioridad ya calculada). Si el lote es grande
+    // respecto del heap se agregan todos y se reconstruye con Floyd en O(n)
+    void insertarLote(const Elemento *lote, int n);
     // Extrae y devuelve el usuario con mayor prioridad (raíz del heap)
     Elemento extraerMax();
     // Actualiza la prioridad de un elemento existente y reordena
     void actualizarPrioridad(int idx, int nuevaPrio);
+    // Cambia la prioridad del usuario con ese DNI; false si no está en cola
+    bool actualizarPrioridadDni(long dni, int nuevaPrio);
+    // Quita de la cola al usuario con ese DNI. Devuelve false si no estaba. O(log n)
+    bool eliminarPorDni(long dni);
 
+    // Devuelve un array con los k elementos de mayor prioridad, en orden,
+    // sin afectar ni copiar el heap: O(k log k)
+    Elemento *verTopK(int k, int &outCount) const;
     // Devuelve un array con los 5 elementos de mayor prioridad
     // Sin afectar el heap original
-    Elemento *verTop5(int &outCount) const;
+    Elemento *verTop5(int &outCount) const { return verTopK(5, outCount); }
 
     // Comprueba si el heap está vacío
-    bool estaVacio() const { return tamanio == 0; }
+    bool estaVacio() const { return heap.estaVacio(); }
 
-    // Busca la posición de un usuario por DNI (O(n))
-    int buscarIndice(long dni) const;
+    // Busca la posición de un usuario por DNI (O(1), -1 si no está en cola)
+    int buscarIndice(long dni) const { return posiciones.obtener(dni); }
+    // Si el usuario está en cola (lo mismo que ColaPorNiveles::contiene)
+    bool contiene(long dni) const { return buscarIndice(dni) >= 0; }
 
     // Permite usar la conversión perfil→prioridad desde fuera
     int perfilAPrioridadPublic(const std::string &perfil) const
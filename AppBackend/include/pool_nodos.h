@@ -0,0 +1,140 @@
+#ifndef POOL_NODOS_H
+#define POOL_NODOS_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Uso de un pool, para reportes y pruebas técnicas
+struct UsoPool
+{
+    size_t tamNodo;            // bytes por celda
+    long enUso;                // nodos vivos
+    long maxEnUso;             // máximo de nodos vivos a la vez
+    long libres;               // celdas devueltas, listas para reusar
+    long capacidad;            // celdas reservadas en total (usadas o no)
+    int bloques;
+    size_t bytesReservados;    // memoria de todos los bloques
+    int bloquesPaginasGrandes; // en hugetlbfs
+};
+
+// Memoria de los bloques de los pools, alineada a línea de caché. Compilando
+// con -DPOOL_PAGINAS_GRANDES (solo Linux) los bloques de TAM_PAGINA_GRANDE
+// se piden en páginas grandes: de hugetlbfs y, si no hay páginas reservadas,
+// alineados a 2 MiB pidiendo páginas grandes transparentes. paginasGrandes
+// indica si el bloque salió de hugetlbfs
+static const size_t TAM_PAGINA_GRANDE = 2 * 1024 * 1024;
+void *reservarBloquePool(size_t bytes, bool &paginasGrandes);
+void liberarBloquePool(void *p, size_t bytes, bool paginasGrandes);
+
+// Pool de nodos de un tipo fijo para las estructuras enlazadas (los nodos
+// de ArbolAVL): en vez de un new por nodo, los nodos se cortan de
+// bloques grandes, y los que se destruyen quedan en una lista libre
+// (enlazada dentro de la misma celda) para el próximo crear. Crear y
+// destruir son O(1) y no piden memoria por nodo (lo que reserve el propio T,
+// como un string largo, va aparte), los nodos creados juntos quedan
+// contiguos y la memoria no se fragmenta entre tamaños.
+// Los bloques crecen al doble desde BYTES_PRIMER_BLOQUE hasta
+// TAM_PAGINA_GRANDE y se liberan recién al destruir el pool.
+// No es thread-safe: lo usa solo el dueño de la estructura (en el servidor,
+// el hilo escritor)
+template <typename T>
+class PoolNodos
+{
+public:
+    static const size_t BYTES_PRIMER_BLOQUE = 4096;
+
+private:
+    union Celda
+    {
+        Celda *siguiente; // si está en la lista libre
+        alignas(T) unsigned char datos[sizeof(T)];
+    };
+
+    struct Bloque
+    {
+        Celda *celdas;
+        size_t cantidad;
+        size_t bytes;
+        bool paginasGrandes;
+    };
+
+    std::vector<Bloque> bloques;
+    size_t entregadas; // celdas del último bloque ya entregadas alguna vez
+    Celda *libres;
+    long enUso;
+    long maxEnUso;
+    long cantidadLibres;
+
+    Celda *celdaNueva()
+    {
+        if (bloques.empty() || entregadas == bloques.back().cantidad)
+        {
+            size_t bytes = bloques.empty() ? BYTES_PRIMER_BLOQUE : bloques.back().bytes * 2;
+            if (bytes > TAM_PAGINA_GRANDE)
+                bytes = TAM_PAGINA_GRANDE;
+            if (bytes < sizeof(Celda))
+                bytes = sizeof(Celda);
+            Bloque b;
+            b.celdas = static_cast<Celda *>(reservarBloquePool(bytes, b.paginasGrandes));
+            b.cantidad = bytes / sizeof(Celda);
+            b.bytes = bytes;
+            bloques.push_back(b);
+            entregadas = 0;
+        }
+        return &bloques.back().celdas[entregadas++];
+    }
+
+public:
+    PoolNodos() : entregadas(0), libres(nullptr), enUso(0), maxEnUso(0), cantidadLibres(0) {}
+    // Los nodos que sigan vivos no se destruyen: el dueño los destruye antes
+    ~PoolNodos()
+    {
+        for (const Bloque &b : bloques)
+            liberarBloquePool(b.celdas, b.bytes, b.paginasGrandes);
+    }
+    PoolNodos(const PoolNodos &) = delete;
+    PoolNodos &operator=(const PoolNodos &) = delete;
+
+    template <typename... Args>
+    T *crear(Args &&...args)
+    {
+        Celda *c = libres;
+        if (c)
+        {
+            libres = c->siguiente;
+            --cantidadLibres;
+        }
+        else
+            c = celdaNueva();
+        T *nodo = new (c->datos) T(std::forward<Args>(args)...);
+        if (++enUso > maxEnUso)
+            maxEnUso = enUso;
+        return nodo;
+    }
+
+    void destruir(T *nodo)
+    {
+        nodo->~T();
+        Celda *c = reinterpret_cast<Celda *>(nodo);
+        c->siguiente = libres;
+        libres = c;
+        ++cantidadLibres;
+        --enUso;
+    }
+
+    UsoPool getUso() const
+    {
+        UsoPool u = {sizeof(Celda), enUso, maxEnUso, cantidadLibres, 0, static_cast<int>(bloques.size()), 0, 0};
+        for (const Bloque &b : bloques)
+        {
+            u.capacidad += static_cast<long>(b.cantidad);
+            u.bytesReservados += b.bytes;
+            u.bloquesPaginasGrandes += b.paginasGrandes ? 1 : 0;
+        }
+        return u;
+    }
+};
+
+#endif
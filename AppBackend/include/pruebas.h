@@ -0,0 +1,44 @@
+#ifndef PRUEBAS_H
+#define PRUEBAS_H
+
+#include <string>
+
+// Pruebas de comportamiento de las estructuras: cada una aplica operaciones
+// al azar (con semilla fija) y compara contra una referencia ingenua de la
+// biblioteca estándar. Se corren con "AppBackend --test". Devuelve la
+// cantidad de pruebas que fallaron
+int ejecutarPruebas();
+
+// Primera diferencia con la referencia: corta la prueba en curso
+struct FallaPrueba
+{
+    std::string detalle;
+};
+
+// Lanza FallaPrueba si no se cumple la condición
+void comprobar(bool condicion, const std::string &detalle);
+
+// Misma tabla perfil→prioridad que MaxHeap y ColaPorNiveles
+const int NUM_PERFILES = 6;
+extern const char *const PERFILES[NUM_PERFILES];
+
+// pruebas_colas.cpp
+void probarIndiceDni();
+void probarDaryHeap();
+void probarMaxHeap();
+void probarColaPorNiveles();
+
+// pruebas_usuarios.cpp
+void probarPendientesTablaHash();
+void probarTablaHashConcurrente();
+void probarListadoTablaConcurrente();
+void probarIndiceBitmap();
+void probarMigracionTablaConcurrente();
+
+// pruebas_accesos.cpp
+void probarArbolAVL();
+void probarIndiceTiempo();
+void probarAlmacenAccesos();
+void probarRetencionAccesos();
+
+#endif
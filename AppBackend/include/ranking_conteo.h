@@ -0,0 +1,33 @@
+#ifndef RANKING_CONTEO_H
+#define RANKING_CONTEO_H
+
+#include <vector>
+
+// Contadores indexados por un id denso (0, 1, 2...) con un ranking de ids
+// ordenado por conteo descendente, de modo que los k ids con más conteo se
+// leen en O(k). Un id que aparece por primera vez entra con conteo 0 (y
+// también los menores que falten), al final del ranking.
+class RankingConteo
+{
+private:
+    std::vector<long> conteos; // contador por id
+    std::vector<int> ranking;  // ids ordenados por conteo descendente
+    std::vector<int> posicion; // posición de cada id en ranking
+
+    // Reubica un id en el ranking tras cambiar su conteo
+    void reordenar(int id);
+
+public:
+    void incrementar(int id, long cantidad = 1);
+
+    // Id con mayor conteo, -1 si vacío. O(1)
+    int idMaximo() const { return ranking.empty() ? -1 : ranking[0]; }
+    // Id en la posición i del ranking (0 = mayor conteo)
+    int idEnPosicion(int i) const { return ranking[i]; }
+
+    // Ids registrados: el mayor visto más uno
+    int getCantidad() const { return static_cast<int>(conteos.size()); }
+    long getConteo(int id) const { return id < getCantidad() ? conteos[id] : 0; }
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef REGISTRO_ZONAS_H
+#define REGISTRO_ZONAS_H
+
+#include <atomic>
+#include <shared_mutex>
+#include <string>
+#include "tabla_conteo.h"
+
+// Diccionario de zonas del proceso: cada nombre recibe una sola vez un id
+// compacto (0, 1, 2...) al ingresar el acceso, y los índices de accesos
+// guardan y cuentan solo ese id. El nombre se resuelve recién al serializar.
+// Registrar una zona conocida toma el lock compartido; solo una zona nueva
+// toma el exclusivo. nombre(id) no toma locks: cada nombre se publica con
+// un puntero atómico y no se mueve ni se borra nunca
+class RegistroZonas
+{
+public:
+    // Los ids entran en las columnas de 16 bits de IndiceTiempo
+    static const int MAX_ZONAS = 65536;
+    // Los ids no se liberan: un nombre vacío o más largo no se registra
+    static const size_t MAX_LARGO_NOMBRE = 64;
+
+private:
+    mutable std::shared_mutex mutex;
+    TablaConteo ids; // nombre -> id (los conteos no se usan)
+    std::atomic<const std::string *> nombres[MAX_ZONAS];
+    std::atomic<int> cantidad;
+
+    RegistroZonas();
+    ~RegistroZonas();
+
+public:
+    RegistroZonas(const RegistroZonas &) = delete;
+    RegistroZonas &operator=(const RegistroZonas &) = delete;
+
+    // Registro único del proceso
+    static RegistroZonas &global();
+
+    // Id de la zona, registrándola si es nueva; -1 si ya hay MAX_ZONAS o
+    // el nombre no es válido
+    int registrar(const std::string &zona);
+    // Id de la zona, o -1 si nunca se registró
+    int buscar(const std::string &zona) const;
+    // Nombre de un id devuelto por registrar
+    const std::string &nombre(int id) const;
+    int getCantidad() const { return cantidad.load(std::memory_order_acquire); }
+};
+
+#endif
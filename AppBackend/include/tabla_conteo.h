@@ -0,0 +1,59 @@
+#ifndef TABLA_CONTEO_H
+#define TABLA_CONTEO_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "ranking_conteo.h"
+
+// Tabla hash de contadores con clave string (zonas, perfiles, etc.).
+// Cada clave se interna una sola vez y recibe un id denso (0, 1, 2...);
+// los contadores se guardan en un arreglo indexado por ese id.
+// Incrementar es O(1) amortizado: un hash de la clave y un sondeo lineal
+// sobre un arreglo de ids que guarda además el hash para descartar rápido.
+// Los contadores y el ranking por conteo son un RankingConteo.
+class TablaConteo
+{
+private:
+    struct Slot
+    {
+        uint32_t hash;
+        int id; // -1 = vacío
+    };
+
+    Slot *slots;
+    int tam; // potencia de dos
+
+    std::vector<std::string> claves; // clave internada por id
+    RankingConteo conteos;
+
+    static uint32_t hashFunc(const std::string &clave);
+    void rehash();
+
+public:
+    TablaConteo(int tamano_inicial = 16);
+    ~TablaConteo();
+    TablaConteo(const TablaConteo &) = delete;
+    TablaConteo &operator=(const TablaConteo &) = delete;
+
+    // Devuelve el id de la clave, o -1 si nunca se registró
+    int buscarId(const std::string &clave) const;
+    // Devuelve el id de la clave, registrándola con conteo 0 si es nueva
+    int internar(const std::string &clave);
+
+    void incrementar(const std::string &clave, long cantidad = 1);
+    void incrementarId(int id, long cantidad = 1);
+    long obtenerConteo(const std::string &clave) const;
+
+    // Id con mayor conteo, -1 si vacía. O(1)
+    int idMaximo() const { return conteos.idMaximo(); }
+    // Id en la posición i del ranking (0 = mayor conteo)
+    int idEnPosicion(int i) const { return conteos.idEnPosicion(i); }
+
+    // Acceso por id para recorrer todas las claves
+    int getCantidad() const { return static_cast<int>(claves.size()); }
+    const std::string &getClave(int id) const { return claves[id]; }
+    long getConteo(int id) const { return conteos.getConteo(id); }
+};
+
+#endif
@@ -0,0 +1,238 @@
+#include "indice_bitmap.h"
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+bool IndiceBitmap::Contenedor::contiene(uint16_t bajo) const
+{
+    if (esMapa())
+        return (mapa[bajo >> 6] >> (bajo & 63)) & 1;
+    return std::binary_search(arreglo.begin(), arreglo.end(), bajo);
+}
+
+void IndiceBitmap::Contenedor::aMapa()
+{
+    mapa.assign(PALABRAS_MAPA, 0);
+    for (uint16_t v : arreglo)
+        mapa[v >> 6] |= uint64_t(1) << (v & 63);
+    std::vector<uint16_t>().swap(arreglo);
+}
+
+void IndiceBitmap::Contenedor::aArreglo()
+{
+    arreglo.reserve(cardinalidad);
+    for (int w = 0; w < PALABRAS_MAPA; ++w)
+    {
+        uint64_t palabra = mapa[w];
+        while (palabra)
+        {
+            arreglo.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(palabra)));
+            palabra &= palabra - 1;
+        }
+    }
+    std::vector<uint64_t>().swap(mapa);
+}
+
+IndiceBitmap::IndiceBitmap()
+    : cardinalidad(0)
+{
+}
+
+int IndiceBitmap::primerContenedorDesde(uint16_t clave) const
+{
+    int lo = 0, hi = static_cast<int>(contenedores.size());
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (contenedores[mid].clave < clave)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+int IndiceBitmap::buscarContenedor(uint16_t clave) const
+{
+    int i = primerContenedorDesde(clave);
+    return (i < static_cast<int>(contenedores.size()) && contenedores[i].clave == clave) ? i : -1;
+}
+
+void IndiceBitmap::agregar(uint32_t id)
+{
+    uint16_t clave = static_cast<uint16_t>(id >> 16);
+    uint16_t bajo = static_cast<uint16_t>(id & 0xFFFF);
+    int i = primerContenedorDesde(clave);
+    if (i == static_cast<int>(contenedores.size()) || contenedores[i].clave != clave)
+    {
+        Contenedor nuevo;
+        nuevo.clave = clave;
+        nuevo.cardinalidad = 0;
+        contenedores.insert(contenedores.begin() + i, nuevo);
+    }
+    Contenedor &c = contenedores[i];
+    if (c.esMapa())
+    {
+        uint64_t bit = uint64_t(1) << (bajo & 63);
+        if (c.mapa[bajo >> 6] & bit)
+            return;
+        c.mapa[bajo >> 6] |= bit;
+    }
+    else
+    {
+        auto pos = std::lower_bound(c.arreglo.begin(), c.arreglo.end(), bajo);
+        if (pos != c.arreglo.end() && *pos == bajo)
+            return;
+        c.arreglo.insert(pos, bajo);
+        if (static_cast<int>(c.arreglo.size()) > MAX_ARREGLO)
+            c.aMapa();
+    }
+    ++c.cardinalidad;
+    ++cardinalidad;
+}
+
+void IndiceBitmap::quitar(uint32_t id)
+{
+    int i = buscarContenedor(static_cast<uint16_t>(id >> 16));
+    if (i < 0)
+        return;
+    uint16_t bajo = static_cast<uint16_t>(id & 0xFFFF);
+    Contenedor &c = contenedores[i];
+    if (c.esMapa())
+    {
+        uint64_t bit = uint64_t(1) << (bajo & 63);
+        if (!(c.mapa[bajo >> 6] & bit))
+            return;
+        c.mapa[bajo >> 6] &= ~bit;
+        --c.cardinalidad;
+        // Umbral más bajo que MAX_ARREGLO para no oscilar entre formatos
+        if (c.cardinalidad < MIN_MAPA)
+            c.aArreglo();
+    }
+    else
+    {
+        auto pos = std::lower_bound(c.arreglo.begin(), c.arreglo.end(), bajo);
+        if (pos == c.arreglo.end() || *pos != bajo)
+            return;
+        c.arreglo.erase(pos);
+        --c.cardinalidad;
+    }
+    --cardinalidad;
+    if (c.cardinalidad == 0)
+        contenedores.erase(contenedores.begin() + i);
+}
+
+bool IndiceBitmap::contiene(uint32_t id) const
+{
+    int i = buscarContenedor(static_cast<uint16_t>(id >> 16));
+    return i >= 0 && contenedores[i].contiene(static_cast<uint16_t>(id & 0xFFFF));
+}
+
+// Si todos son mapas, AND palabra a palabra; si no, se recorre el arreglo
+// más chico y se prueba cada valor en los demás
+void IndiceBitmap::intersectarContenedores(const Contenedor *const *cs, int n, uint32_t inicio,
+                                           std::vector<uint32_t> &out, size_t tope)
+{
+    uint32_t alto = static_cast<uint32_t>(cs[0]->clave) << 16;
+    const Contenedor *menor = nullptr;
+    for (int j = 0; j < n; ++j)
+    {
+        if (!cs[j]->esMapa() && (!menor || cs[j]->cardinalidad < menor->cardinalidad))
+            menor = cs[j];
+    }
+
+    if (menor)
+    {
+        auto it = std::lower_bound(menor->arreglo.begin(), menor->arreglo.end(), static_cast<uint16_t>(inicio));
+        for (; it != menor->arreglo.end() && out.size() < tope; ++it)
+        {
+            bool enTodos = true;
+            for (int j = 0; j < n && enTodos; ++j)
+                enTodos = cs[j] == menor || cs[j]->contiene(*it);
+            if (enTodos)
+                out.push_back(alto | *it);
+        }
+        return;
+    }
+
+    // Se arranca en la palabra par que contiene a "inicio" (de a dos con SSE2)
+    int w = static_cast<int>(inicio >> 6) & ~1;
+    for (; w < PALABRAS_MAPA && out.size() < tope; w += 2)
+    {
+        uint64_t par[2];
+#ifdef __SSE2__
+        __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&cs[0]->mapa[w]));
+        for (int j = 1; j < n; ++j)
+            acc = _mm_and_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i *>(&cs[j]->mapa[w])));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(par), acc);
+#else
+        par[0] = cs[0]->mapa[w];
+        par[1] = cs[0]->mapa[w + 1];
+        for (int j = 1; j < n; ++j)
+        {
+            par[0] &= cs[j]->mapa[w];
+            par[1] &= cs[j]->mapa[w + 1];
+        }
+#endif
+        for (int k = 0; k < 2 && out.size() < tope; ++k)
+        {
+            uint64_t palabra = par[k];
+            uint32_t base = static_cast<uint32_t>(w + k) * 64;
+            // Bits anteriores a "inicio" en su propia palabra
+            if (base + 64 <= inicio)
+                continue;
+            if (base < inicio)
+                palabra &= ~uint64_t(0) << (inicio - base);
+            while (palabra && out.size() < tope)
+            {
+                out.push_back(alto | (base + __builtin_ctzll(palabra)));
+                palabra &= palabra - 1;
+            }
+        }
+    }
+}
+
+long IndiceBitmap::interseccion(const IndiceBitmap *const *conjuntos, int n, uint32_t desde,
+                                int limite, std::vector<uint32_t> &out)
+{
+    out.clear();
+    if (n <= 0 || limite <= 0)
+        return -1;
+
+    // Se recorren los contenedores del conjunto con menos contenedores
+    const IndiceBitmap *guia = conjuntos[0];
+    for (int j = 1; j < n; ++j)
+    {
+        if (conjuntos[j]->contenedores.size() < guia->contenedores.size())
+            guia = conjuntos[j];
+    }
+
+    // Se junta un elemento de más para saber dónde empieza la página siguiente
+    size_t tope = static_cast<size_t>(limite) + 1;
+    std::vector<const Contenedor *> cs(n);
+    uint16_t claveDesde = static_cast<uint16_t>(desde >> 16);
+    for (int i = guia->primerContenedorDesde(claveDesde);
+         i < static_cast<int>(guia->contenedores.size()) && out.size() < tope; ++i)
+    {
+        uint16_t clave = guia->contenedores[i].clave;
+        bool enTodos = true;
+        for (int j = 0; j < n && enTodos; ++j)
+        {
+            int k = conjuntos[j]->buscarContenedor(clave);
+            enTodos = k >= 0;
+            if (enTodos)
+                cs[j] = &conjuntos[j]->contenedores[k];
+        }
+        if (!enTodos)
+            continue;
+        uint32_t inicio = clave == claveDesde ? (desde & 0xFFFF) : 0;
+        intersectarContenedores(cs.data(), n, inicio, out, tope);
+    }
+
+    if (out.size() < tope)
+        return -1;
+    long siguiente = out.back();
+    out.pop_back();
+    return siguiente;
+}
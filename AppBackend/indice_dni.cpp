@@ -0,0 +1,126 @@
+#include "indice_dni.h"
+#include <climits>
+
+// Clave reservada para slots libres (ningún DNI válido la usa)
+static const long VACIO = LONG_MIN;
+
+IndiceDni::IndiceDni(int tamano_inicial)
+    : tam(16), usados(0)
+{
+    while (tam < tamano_inicial)
+        tam *= 2;
+    claves = new long[tam];
+    valores = new int[tam];
+    for (int i = 0; i < tam; ++i)
+        claves[i] = VACIO;
+}
+
+IndiceDni::~IndiceDni()
+{
+    delete[] claves;
+    delete[] valores;
+}
+
+int IndiceDni::slotIdeal(long dni) const
+{
+    unsigned long long h = static_cast<unsigned long long>(dni) * 0x9E3779B97F4A7C15ull;
+    return static_cast<int>(h >> 32) & (tam - 1);
+}
+
+// Duplica la capacidad y reubica todos los pares
+void IndiceDni::crecer()
+{
+    long *viejasClaves = claves;
+    int *viejosValores = valores;
+    int viejoTam = tam;
+
+    tam *= 2;
+    claves = new long[tam];
+    valores = new int[tam];
+    for (int i = 0; i < tam; ++i)
+        claves[i] = VACIO;
+
+    int mascara = tam - 1;
+    for (int j = 0; j < viejoTam; ++j)
+    {
+        if (viejasClaves[j] == VACIO)
+            continue;
+        int i = slotIdeal(viejasClaves[j]);
+        while (claves[i] != VACIO)
+            i = (i + 1) & mascara;
+        claves[i] = viejasClaves[j];
+        valores[i] = viejosValores[j];
+    }
+    delete[] viejasClaves;
+    delete[] viejosValores;
+}
+
+void IndiceDni::asignar(long dni, int pos)
+{
+    int mascara = tam - 1;
+    int i = slotIdeal(dni);
+    while (claves[i] != VACIO)
+    {
+        if (claves[i] == dni)
+        {
+            valores[i] = pos;
+            return;
+        }
+        i = (i + 1) & mascara;
+    }
+    claves[i] = dni;
+    valores[i] = pos;
+    ++usados;
+    // Factor de carga máximo 1/2 para mantener los sondeos cortos
+    if (2 * usados > tam)
+        crecer();
+}
+
+int IndiceDni::obtener(long dni) const
+{
+    int mascara = tam - 1;
+    for (int i = slotIdeal(dni); claves[i] != VACIO; i = (i + 1) & mascara)
+    {
+        if (claves[i] == dni)
+            return valores[i];
+    }
+    return -1;
+}
+
+void IndiceDni::eliminar(long dni)
+{
+    int mascara = tam - 1;
+    int i = slotIdeal(dni);
+    while (claves[i] != dni)
+    {
+        if (claves[i] == VACIO)
+            return;
+        i = (i + 1) & mascara;
+    }
+
+    // Backward shift: se adelantan los elementos cuyo slot ideal no queda
+    // entre el hueco y su posición actual
+    int j = i;
+    while (true)
+    {
+        j = (j + 1) & mascara;
+        if (claves[j] == VACIO)
+            break;
+        int k = slotIdeal(claves[j]);
+        bool enRango = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+        if (enRango)
+            continue;
+        claves[i] = claves[j];
+        valores[i] = valores[j];
+        i = j;
+    }
+    claves[i] = VACIO;
+    --usados;
+}
+
+void IndiceDni::limpiar()
+{
+    for (int i = 0; i < tam; ++i)
+        claves[i] = VACIO;
+    usados = 0;
+}
@@ -0,0 +1,418 @@
+#include "indice_tiempo.h"
+#include "registro_zonas.h"
+#include <algorithm>
+#include <climits>
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Hasta esta cantidad de zonas conviene contar una zona por vez con SIMD;
+// con más, el histograma escalar (un acceso por id) es más barato
+static const int MAX_ZONAS_SIMD = 8;
+
+static bool claveMenor(long ts1, long seq1, long ts2, long seq2)
+{
+    return ts1 < ts2 || (ts1 == ts2 && seq1 < seq2);
+}
+
+IteradorTiempo::IteradorTiempo(const IndiceTiempo *ind, long p, IteradorAVL r)
+    : indice(ind), pos(p), rez(r), enSegmento(false), actual{0, 0, 0}
+{
+    elegir();
+}
+
+// El actual es el menor entre el siguiente del segmento y el siguiente
+// rezagado
+void IteradorTiempo::elegir()
+{
+    bool haySegmento = pos < indice->cantidadSegmento;
+    if (!haySegmento && !rez.valido())
+    {
+        indice = nullptr;
+        return;
+    }
+    if (haySegmento)
+    {
+        Acceso a = indice->enSegmento(pos);
+        if (!rez.valido() || claveMenor(a.timestamp, a.secuencia, rez->timestamp, rez->secuencia))
+        {
+            actual = a;
+            actual.zonaId = indice->zonaGlobal[a.zonaId];
+            enSegmento = true;
+            return;
+        }
+    }
+    actual = {rez->timestamp, rez->secuencia, indice->zonaGlobal[rez->zonaId]};
+    enSegmento = false;
+}
+
+IteradorTiempo &IteradorTiempo::operator++()
+{
+    if (enSegmento)
+        ++pos;
+    else
+        ++rez;
+    elegir();
+    return *this;
+}
+
+IndiceTiempo::IndiceTiempo(PoolNodos<NodoAVL> *poolRezagados)
+    : cantidadSegmento(0), rezagados(new ArbolAVL(poolRezagados)), siguienteSecuencia(0)
+{
+}
+
+IndiceTiempo::~IndiceTiempo()
+{
+    for (BloqueAccesos *b : bloques)
+        delete b;
+    delete rezagados;
+}
+
+void IndiceTiempo::agregarAlFinal(const Acceso &a)
+{
+    long i = cantidadSegmento;
+    size_t b = static_cast<size_t>(i / TAM_BLOQUE);
+    int j = static_cast<int>(i % TAM_BLOQUE);
+    if (j == 0)
+    {
+        if (b == bloques.size())
+        {
+            bloques.push_back(new BloqueAccesos);
+            minBloque.push_back(a.timestamp);
+            maxBloque.push_back(a.timestamp);
+            prefijoZonas.push_back(conteoSegmento);
+        }
+        else
+        {
+            minBloque[b] = a.timestamp;
+            prefijoZonas[b] = conteoSegmento;
+        }
+    }
+    BloqueAccesos *bloque = bloques[b];
+    bloque->ts[j] = a.timestamp;
+    bloque->seq[j] = static_cast<uint32_t>(a.secuencia);
+    bloque->zona[j] = static_cast<uint16_t>(a.zonaId);
+    maxBloque[b] = a.timestamp;
+    ++cantidadSegmento;
+    if (a.zonaId >= static_cast<int>(conteoSegmento.size()))
+        conteoSegmento.resize(a.zonaId + 1, 0);
+    ++conteoSegmento[a.zonaId];
+}
+
+// Camino rápido: si no retrocede en el tiempo va al final del segmento
+int IndiceTiempo::idLocal(int zonaId)
+{
+    auto it = zonaLocal.find(zonaId);
+    if (it != zonaLocal.end())
+        return it->second;
+    int local = static_cast<int>(zonaGlobal.size());
+    zonaGlobal.push_back(zonaId);
+    zonaLocal.emplace(zonaId, local);
+    return local;
+}
+
+void IndiceTiempo::insertar(int zonaGlobalId, long ts)
+{
+    int zonaId = idLocal(zonaGlobalId);
+    conteoZonas.incrementar(zonaId);
+    long seq = siguienteSecuencia++;
+    if (cantidadSegmento == 0 || ts >= enSegmento(cantidadSegmento - 1).timestamp)
+    {
+        agregarAlFinal({ts, seq, zonaId});
+        return;
+    }
+    rezagados->insertar(zonaId, ts, seq);
+    if (rezagados->getCantidad() >= MAX_REZAGADOS)
+        mezclarRezagados();
+}
+
+void IndiceTiempo::insertar(const std::string &zona, long ts)
+{
+    int zonaId = RegistroZonas::global().registrar(zona);
+    if (zonaId >= 0)
+        insertar(zonaId, ts);
+}
+
+// Los rezagados suelen llegar poco tarde: solo se reescribe el segmento
+// desde donde iría el más viejo de ellos
+void IndiceTiempo::mezclarRezagados()
+{
+    IteradorAVL it = rezagados->desde(LONG_MIN, -1);
+    long p = posicionSegmento(it->timestamp, it->secuencia);
+
+    std::vector<Acceso> cola;
+    cola.reserve(static_cast<size_t>(cantidadSegmento - p + rezagados->getCantidad()));
+    long i = p;
+    while (i < cantidadSegmento || it.valido())
+    {
+        if (i < cantidadSegmento && (!it.valido() || claveHasta(i, it->timestamp, it->secuencia)))
+        {
+            cola.push_back(enSegmento(i++));
+        }
+        else
+        {
+            cola.push_back({it->timestamp, it->secuencia, it->zonaId});
+            ++it;
+        }
+    }
+
+    // Trunca el segmento en p y vuelve a agregar la cola ya ordenada
+    std::vector<long> antes(conteoZonas.getCantidad(), 0);
+    contarZonasSegmento(p, antes, 1);
+    conteoSegmento.swap(antes);
+    cantidadSegmento = p;
+    for (const Acceso &a : cola)
+        agregarAlFinal(a);
+
+    rezagados->vaciar();
+}
+
+// Las claves son únicas, así que para una clave ajena al segmento "<=" y
+// "<" coinciden
+bool IndiceTiempo::claveHasta(long i, long ts, long seq) const
+{
+    const BloqueAccesos *b = bloques[i / TAM_BLOQUE];
+    int j = static_cast<int>(i % TAM_BLOQUE);
+    return b->ts[j] < ts || (b->ts[j] == ts && static_cast<long>(b->seq[j]) <= seq);
+}
+
+// Con el directorio se acota la búsqueda a los bloques cuyo intervalo
+// contiene a ts (normalmente uno): los anteriores tienen todas sus claves
+// menores y los siguientes todas mayores. Dentro se busca sobre las columnas
+long IndiceTiempo::posicionSegmento(long ts, long seq) const
+{
+    long usados = (cantidadSegmento + TAM_BLOQUE - 1) / TAM_BLOQUE;
+    long primero = std::lower_bound(maxBloque.begin(), maxBloque.begin() + usados, ts) - maxBloque.begin();
+    long ultimo = std::upper_bound(minBloque.begin(), minBloque.begin() + usados, ts) - minBloque.begin();
+    long lo = std::min(primero * TAM_BLOQUE, cantidadSegmento);
+    long hi = std::min(ultimo * TAM_BLOQUE, cantidadSegmento);
+    while (lo < hi)
+    {
+        long mid = lo + (hi - lo) / 2;
+        if (claveHasta(mid, ts, seq))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// Con pocas zonas se cuenta una zona por vez: se comparan 16 ids (AVX2) u
+// 8 (SSE2) por instrucción y cada coincidencia (-1) se resta del
+// acumulador. Los contadores de 16 bits no desbordan porque una columna
+// tiene a lo sumo TAM_BLOQUE ids
+void IndiceTiempo::contarZonasColumna(const uint16_t *zonas, int n, int numZonas,
+                                      std::vector<long> &acum, long signo)
+{
+#if defined(__AVX2__) || defined(__SSE2__)
+    if (numZonas <= MAX_ZONAS_SIMD)
+    {
+        for (int z = 0; z < numZonas; ++z)
+        {
+            int i = 0;
+            long c = 0;
+#ifdef __AVX2__
+            __m256i clave = _mm256_set1_epi16(static_cast<short>(z));
+            __m256i acc = _mm256_setzero_si256();
+            for (; i + 16 <= n; i += 16)
+            {
+                __m256i ids = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(zonas + i));
+                acc = _mm256_sub_epi16(acc, _mm256_cmpeq_epi16(ids, clave));
+            }
+            uint16_t partes[16];
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(partes), acc);
+            for (int k = 0; k < 16; ++k)
+                c += partes[k];
+#else
+            __m128i clave = _mm_set1_epi16(static_cast<short>(z));
+            __m128i acc = _mm_setzero_si128();
+            for (; i + 8 <= n; i += 8)
+            {
+                __m128i ids = _mm_loadu_si128(reinterpret_cast<const __m128i *>(zonas + i));
+                acc = _mm_sub_epi16(acc, _mm_cmpeq_epi16(ids, clave));
+            }
+            uint16_t partes[8];
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(partes), acc);
+            for (int k = 0; k < 8; ++k)
+                c += partes[k];
+#endif
+            for (; i < n; ++i)
+                c += zonas[i] == z;
+            acum[z] += signo * c;
+        }
+        return;
+    }
+#endif
+    for (int i = 0; i < n; ++i)
+        acum[zonas[i]] += signo;
+}
+
+// Bloques completos con los prefijos; del bloque partido se recorre la
+// parte más corta: desde su inicio, o hasta su final restando del prefijo
+// siguiente
+void IndiceTiempo::contarZonasSegmento(long n, std::vector<long> &acum, long signo) const
+{
+    if (n <= 0)
+        return;
+    if (n == cantidadSegmento)
+    {
+        for (size_t z = 0; z < conteoSegmento.size(); ++z)
+            acum[z] += signo * conteoSegmento[z];
+        return;
+    }
+    long b = n / TAM_BLOQUE;
+    int antes = static_cast<int>(n % TAM_BLOQUE);
+    int enBloque = static_cast<int>(std::min<long>(TAM_BLOQUE, cantidadSegmento - b * TAM_BLOQUE));
+    bool desdeFinal = antes > enBloque - antes;
+    bool ultimoBloque = (b + 1) * TAM_BLOQUE >= cantidadSegmento;
+    const std::vector<long> &prefijo = !desdeFinal ? prefijoZonas[b]
+                                       : ultimoBloque ? conteoSegmento
+                                                      : prefijoZonas[b + 1];
+    for (size_t z = 0; z < prefijo.size(); ++z)
+        acum[z] += signo * prefijo[z];
+    int numZonas = static_cast<int>(conteoSegmento.size());
+    if (desdeFinal)
+        contarZonasColumna(bloques[b]->zona + antes, enBloque - antes, numZonas, acum, -signo);
+    else
+        contarZonasColumna(bloques[b]->zona, antes, numZonas, acum, signo);
+}
+
+size_t IndiceTiempo::getMemoria() const
+{
+    size_t bytes = bloques.size() * sizeof(BloqueAccesos) +
+                   (minBloque.capacity() + maxBloque.capacity()) * sizeof(int64_t);
+    for (const std::vector<long> &p : prefijoZonas)
+        bytes += p.capacity() * sizeof(long);
+    // Mapa de zonas: cada nodo guarda el par y el puntero al siguiente
+    bytes += zonaGlobal.capacity() * sizeof(int) +
+             zonaLocal.size() * (sizeof(std::pair<const int, int>) + sizeof(void *)) +
+             zonaLocal.bucket_count() * sizeof(void *) +
+             conteoZonas.getCantidad() * (sizeof(long) + 2 * sizeof(int));
+    return bytes + rezagados->getMemoria();
+}
+
+IteradorTiempo IndiceTiempo::desde(long ts, long seq) const
+{
+    return IteradorTiempo(this, posicionSegmento(ts, seq), rezagados->desde(ts, seq));
+}
+
+bool IndiceTiempo::rangoPagina(long desdeTs, long desdeSeq, long fin, int limite,
+                               std::vector<Acceso> &out) const
+{
+    out.clear();
+    IteradorTiempo it = desde(desdeTs, desdeSeq);
+    for (; it.valido() && it->timestamp <= fin && static_cast<int>(out.size()) < limite; ++it)
+        out.push_back(*it);
+    return it.valido() && it->timestamp <= fin;
+}
+
+long IndiceTiempo::contarHasta(long ts, long seq) const
+{
+    return posicionSegmento(ts, seq) + rezagados->contarHasta(ts, seq);
+}
+
+long IndiceTiempo::contarRango(long inicio, long fin) const
+{
+    if (inicio > fin)
+        return 0;
+    return contarHasta(fin, LONG_MAX) - contarHasta(inicio, -1);
+}
+
+// Se busca en el segmento la primera posición cuyo rango global (posición
+// más rezagados anteriores) llega a k. Si no es exactamente k, el k-ésimo
+// es un rezagado, y antes de él hay "lo" accesos del segmento
+bool IndiceTiempo::seleccionar(long k, Acceso &out) const
+{
+    if (k < 0 || k >= getCantidad())
+        return false;
+    long lo = 0, hi = cantidadSegmento;
+    while (lo < hi)
+    {
+        long mid = lo + (hi - lo) / 2;
+        Acceso a = enSegmento(mid);
+        if (mid + rezagados->contarHasta(a.timestamp, a.secuencia) < k)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo < cantidadSegmento)
+    {
+        Acceso a = enSegmento(lo);
+        if (lo + rezagados->contarHasta(a.timestamp, a.secuencia) == k)
+        {
+            out = a;
+            out.zonaId = zonaGlobal[a.zonaId];
+            return true;
+        }
+    }
+    NodoAVL *n = rezagados->seleccionar(k - lo);
+    out = {n->timestamp, n->secuencia, zonaGlobal[n->zonaId]};
+    return true;
+}
+
+std::vector<long> IndiceTiempo::conteoZonasLocalesEnRango(long inicio, long fin) const
+{
+    std::vector<long> acum(zonaGlobal.size(), 0);
+    if (inicio > fin)
+        return acum;
+    contarZonasSegmento(posicionSegmento(fin, LONG_MAX), acum, 1);
+    contarZonasSegmento(posicionSegmento(inicio, -1), acum, -1);
+    if (rezagados->getCantidad() > 0)
+    {
+        std::vector<long> r = rezagados->conteoZonasEnRango(inicio, fin);
+        for (size_t z = 0; z < r.size(); ++z)
+            acum[z] += r[z];
+    }
+    return acum;
+}
+
+std::vector<long> IndiceTiempo::conteoZonasEnRango(long inicio, long fin) const
+{
+    std::vector<long> local = conteoZonasLocalesEnRango(inicio, fin);
+    int maxGlobal = -1;
+    for (int g : zonaGlobal)
+        maxGlobal = std::max(maxGlobal, g);
+    std::vector<long> acum(maxGlobal + 1, 0);
+    for (size_t z = 0; z < local.size(); ++z)
+        acum[zonaGlobal[z]] = local[z];
+    return acum;
+}
+
+std::string IndiceTiempo::zonaMasEntradas(long inicio, long fin) const
+{
+    std::vector<long> conteo = conteoZonasLocalesEnRango(inicio, fin);
+    int mejor = -1;
+    for (int z = 0; z < static_cast<int>(conteo.size()); ++z)
+    {
+        if (conteo[z] > 0 && (mejor < 0 || conteo[z] > conteo[mejor]))
+            mejor = z;
+    }
+    return mejor < 0 ? std::string() : nombreZona(zonaGlobal[mejor]);
+}
+
+std::string IndiceTiempo::zonaMasEntradas() const
+{
+    int mejor = conteoZonas.idMaximo();
+    return mejor < 0 ? std::string() : nombreZona(zonaGlobal[mejor]);
+}
+
+const std::string &IndiceTiempo::nombreZona(int zonaId) const
+{
+    return RegistroZonas::global().nombre(zonaId);
+}
+
+std::vector<std::pair<std::string, long>> IndiceTiempo::zonasTop(int k) const
+{
+    std::vector<std::pair<std::string, long>> out;
+    int n = conteoZonas.getCantidad();
+    if (k > n)
+        k = n;
+    for (int i = 0; i < k; ++i)
+    {
+        int id = conteoZonas.idEnPosicion(i);
+        out.push_back({nombreZona(zonaGlobal[id]), conteoZonas.getConteo(id)});
+    }
+    return out;
+}
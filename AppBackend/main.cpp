@@ -1,21 +1,112 @@
+// La cola de conexiones por defecto (5) corta ráfagas de clientes concurrentes
+#define CPPHTTPLIB_LISTEN_BACKLOG 128
 #include "httplib.h"
 #include "json.hpp"
 #include "hash_table.h"
+#include "hash_table_encadenada.h"
+#include "hash_table_concurrente.h"
 #include "max_heap.h"
+#include "cola_niveles.h"
 #include "avl_tree.h"
+#include "almacen_accesos.h"
+#include "registro_zonas.h"
+#include "bucle_escritor.h"
+#include "pruebas.h"
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
 #include <chrono>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <memory>
+#include <atomic>
+#include <thread>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 using json = nlohmann::json;
 using namespace httplib;
 
-// Estructuras principales
-TablaHash usuarios;
-MaxHeap heap;
-ArbolAVL arbol;
+// Motor de la cola de prioridad: heap binario por defecto, o la cola por
+// niveles (un FIFO por prioridad) compilando con -DCOLA_POR_NIVELES
+#ifdef COLA_POR_NIVELES
+typedef ColaPorNiveles ColaUsuarios;
+#else
+typedef MaxHeap ColaUsuarios;
+#endif
+
+// Accesos: segundos por partición y retención en segundos hacia atrás desde
+// el acceso más nuevo (30 días por defecto; 0 = sin límite). Se cambian
+// compilando con, por ejemplo, -DPARTICION_ACCESOS=86400
+// -DRETENCION_ACCESOS=604800
+#ifndef PARTICION_ACCESOS
+#define PARTICION_ACCESOS 3600
+#endif
+#ifndef RETENCION_ACCESOS
+#define RETENCION_ACCESOS 2592000
+#endif
+
+// Segundos que un acceso puede adelantarse al reloj del servidor
+const long MARGEN_FUTURO_ACCESOS = 300;
+
+// Estructuras principales. Solo el hilo escritor modifica la cola y los accesos
+// (con escritor.ejecutar); sus lecturas toman escritor.vista() en modo
+// compartido. La tabla de usuarios tiene sus propios locks por fragmento
+TablaHashConcurrente usuarios;
+ColaUsuarios heap;
+AlmacenAccesos accesos(PARTICION_ACCESOS, RETENCION_ACCESOS);
+BucleEscritor escritor;
+
+// Resultados de lectura frecuente, recalculados al terminar cada lote de
+// escrituras que cambió la cola o los accesos. Los handlers los leen sin
+// tomar ningún lock
+struct FilaCola
+{
+    long dni;
+    std::string perfil;
+    int prioridad;
+    long ts;
+};
+
+struct VistaPublicada
+{
+    static const int TOP_COLA = 50;
+    static const int TOP_ZONAS = 32;
+    std::vector<FilaCola> cola;                         // primeros TOP_COLA
+    std::vector<std::pair<std::string, long>> zonas; // primeras TOP_ZONAS
+    std::string zonaTop;
+};
+
+std::shared_ptr<const VistaPublicada> vistaActual;
+// Los comandos del escritor que cambian la cola o los accesos la encienden;
+// un lote que solo consulta o rechaza no vuelve a armar la vista. La usa
+// solo el hilo escritor
+bool vistaSucia = true;
+
+// Se llama desde el hilo escritor con la vista tomada en modo exclusivo
+void publicarVista()
+{
+    if (!vistaSucia)
+        return;
+    vistaSucia = false;
+    auto v = std::make_shared<VistaPublicada>();
+    int count = 0;
+    Elemento *top = heap.verTopK(VistaPublicada::TOP_COLA, count);
+    v->cola.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        std::string perfil = "-";
+        usuarios.obtenerPerfil(top[i].dni, perfil);
+        v->cola.push_back({top[i].dni, perfil, top[i].prioridad, top[i].ts});
+    }
+    delete[] top;
+    v->zonas = accesos.zonasTop(VistaPublicada::TOP_ZONAS);
+    v->zonaTop = accesos.zonaMasEntradas();
+    std::atomic_store(&vistaActual, std::shared_ptr<const VistaPublicada>(v));
+}
 
 // Cargar datos y medir tiempos y espacio para análisis técnico
 void cargarDatosInicialesPruebaTecnica(const std::string &path)
@@ -79,7 +170,8 @@ void cargarDatosInicialesPruebaTecnica(const std::string &path)
             continue;
 
         heapTest.insertar(dni, perfil, ts);
-        nodo->enCola = true;
+        // Por marcarEnCola, como /cola, para que el índice de pendientes siga al día
+        tablaTest.marcarEnCola(dni, true);
         ++insertados;
     }
     t2 = std::chrono::high_resolution_clock::now();
@@ -209,6 +301,529 @@ void cargarDatosInicialesPruebaTecnica(const std::string &path)
               << std::chrono::duration<double, std::micro>(t2 - t1).count() << " us, resultados: " << rango.size() << "\n";
 }
 
+// Mide insertar + buscar (existentes y no existentes) sobre una tabla dada.
+// Las consultas van en otro orden que las inserciones para no favorecer
+// a la tabla encadenada, cuyos nodos quedan contiguos en orden de inserción
+template <typename Tabla>
+void medirTabla(const char *nombre, const std::vector<long> &dnis, const std::vector<long> &consultas)
+{
+    Tabla tabla;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (long dni : dnis)
+        tabla.insertar(dni, "publico-general");
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double msInsertar = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+    int encontrados = 0;
+    t1 = std::chrono::high_resolution_clock::now();
+    for (long dni : consultas)
+        if (tabla.buscar(dni))
+            ++encontrados;
+    t2 = std::chrono::high_resolution_clock::now();
+    double msBuscar = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+    t1 = std::chrono::high_resolution_clock::now();
+    for (long dni : consultas)
+        if (tabla.validar(dni + 50000000)) // fuera del rango generado
+            ++encontrados;
+    t2 = std::chrono::high_resolution_clock::now();
+    double msFallidas = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+    std::cout << "  " << nombre << ": insertar " << msInsertar << " ms, buscar "
+              << msBuscar << " ms, validar (no existen) " << msFallidas
+              << " ms (encontrados: " << encontrados << ")\n";
+}
+
+// Prueba técnica: tabla encadenada original vs direccionamiento abierto (SSE2) de 10^3 a 10^7 usuarios con DNIs
+// desordenados
+void compararTablasHash()
+{
+    std::mt19937 gen(42);
+    for (long n = 1000; n <= 10000000; n *= 10)
+    {
+        std::vector<long> dnis(n);
+        for (long i = 0; i < n; ++i)
+            dnis[i] = 10000000 + i;
+        std::shuffle(dnis.begin(), dnis.end(), gen);
+        std::vector<long> consultas(dnis);
+        std::shuffle(consultas.begin(), consultas.end(), gen);
+
+        std::cout << "[Hash] " << n << " usuarios\n";
+        medirTabla<TablaHashEncadenada>("Encadenada ", dnis, consultas);
+        medirTabla<TablaHash>("Dir. abierto", dnis, consultas);
+    }
+}
+
+// La tabla de un solo hilo detrás de un lock lector/escritor global: la
+// referencia contra la que se comparan las búsquedas sin lock
+struct TablaHashConLock
+{
+    TablaHash tabla;
+    mutable std::shared_mutex lock;
+
+    bool insertar(long dni, const std::string &perfil)
+    {
+        std::unique_lock<std::shared_mutex> lk(lock);
+        if (tabla.validar(dni))
+            return false;
+        tabla.insertar(dni, perfil);
+        return true;
+    }
+    bool validar(long dni) const
+    {
+        std::shared_lock<std::shared_mutex> lk(lock);
+        return tabla.validar(dni);
+    }
+};
+
+// Lanza "hilos" hilos que validan DNIs existentes al azar; uno de cada 64
+// pasos inserta un DNI nuevo (como un POST /usuario). Devuelve millones de
+// operaciones por segundo entre todos los hilos
+template <typename Tabla>
+double medirHilos(Tabla &tabla, int hilos, const std::vector<long> &dnis, long &siguienteNuevo)
+{
+    const int OPS_POR_HILO = 1000000;
+    std::vector<std::thread> ts;
+    std::atomic<int> encontrados(0);
+    long baseNuevos = siguienteNuevo;
+    siguienteNuevo += static_cast<long>(hilos) * OPS_POR_HILO;
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int h = 0; h < hilos; ++h)
+    {
+        ts.emplace_back([&, h]
+                        {
+            std::mt19937 gen(h);
+            long nuevo = baseNuevos + static_cast<long>(h) * OPS_POR_HILO;
+            int locales = 0;
+            for (int i = 0; i < OPS_POR_HILO; ++i) {
+                if ((i & 63) == 63)
+                    tabla.insertar(nuevo++, "publico-general");
+                else if (tabla.validar(dnis[gen() % dnis.size()]))
+                    ++locales;
+            }
+            encontrados += locales; });
+    }
+    for (auto &t : ts)
+        t.join();
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double seg = std::chrono::duration<double>(t2 - t1).count();
+    return hilos * (OPS_POR_HILO / 1e6) / seg;
+}
+
+// Latencia de cada validación (p50/p99/p99.9) con "lectores" hilos mientras
+// un escritor inserta sin pausa, como una ola de registros
+template <typename Tabla>
+void medirLatencia(const char *nombre, Tabla &tabla, int lectores, const std::vector<long> &dnis)
+{
+    const int OPS_POR_LECTOR = 200000;
+    std::atomic<bool> leyendo(true);
+    std::atomic<long> insertados(0);
+    std::thread escritor([&]
+                         {
+        long nuevo = 200000000;
+        while (leyendo.load(std::memory_order_relaxed)) {
+            tabla.insertar(nuevo++, "publico-general");
+            insertados.fetch_add(1, std::memory_order_relaxed);
+        } });
+
+    std::vector<std::vector<double>> tiempos(lectores, std::vector<double>(OPS_POR_LECTOR));
+    std::vector<std::thread> ts;
+    for (int h = 0; h < lectores; ++h)
+    {
+        ts.emplace_back([&, h]
+                        {
+            std::mt19937 gen(h);
+            for (int i = 0; i < OPS_POR_LECTOR; ++i) {
+                long dni = dnis[gen() % dnis.size()];
+                auto t1 = std::chrono::steady_clock::now();
+                tabla.validar(dni);
+                auto t2 = std::chrono::steady_clock::now();
+                tiempos[h][i] = std::chrono::duration<double, std::nano>(t2 - t1).count();
+            } });
+    }
+    for (auto &t : ts)
+        t.join();
+    leyendo.store(false);
+    escritor.join();
+
+    std::vector<double> todos;
+    for (auto &v : tiempos)
+        todos.insert(todos.end(), v.begin(), v.end());
+    std::sort(todos.begin(), todos.end());
+    auto percentil = [&](double p)
+    { return todos[static_cast<size_t>(p * (todos.size() - 1))]; };
+    std::cout << "  " << nombre << ": p50 " << percentil(0.5) << " ns, p99 " << percentil(0.99)
+              << " ns, p99.9 " << percentil(0.999) << " ns (" << insertados.load()
+              << " inserciones en paralelo)\n";
+}
+
+// Prueba técnica: tabla con lock global contra la tabla por fragmentos con
+// búsquedas sin lock. Rendimiento de 1 hilo hasta el doble de núcleos, y
+// latencia de las validaciones durante una ola de inserciones
+void compararHashConcurrente()
+{
+    const long n = 1000000;
+    std::vector<long> dnis(n);
+    for (long i = 0; i < n; ++i)
+        dnis[i] = 10000000 + i;
+
+    int nucleos = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    long siguienteNuevo = 100000000;
+
+    TablaHashConLock conLock;
+    TablaHashConcurrente sinLock;
+    for (long dni : dnis)
+    {
+        conLock.insertar(dni, "publico-general");
+        sinLock.insertar(dni, "publico-general");
+    }
+
+    std::cout << "[Hash concurrente] Mops/s (1 de cada 64 operaciones inserta)\n";
+    for (int hilos = 1; hilos <= 2 * nucleos; hilos *= 2)
+    {
+        std::cout << "  " << hilos << " hilos: lock global " << medirHilos(conLock, hilos, dnis, siguienteNuevo);
+        std::cout << ", fragmentos sin lock " << medirHilos(sinLock, hilos, dnis, siguienteNuevo) << "\n";
+    }
+
+    std::cout << "[Hash concurrente] Latencia de validar con un escritor insertando\n";
+    medirLatencia("Lock global       ", conLock, nucleos, dnis);
+    medirLatencia("Fragmentos sin lock", sinLock, nucleos, dnis);
+}
+
+// Mide insertar, top 5 y vaciar la cola con un motor dado
+template <typename Cola>
+void medirCola(const char *nombre, const std::vector<long> &ts, const char *const *perfiles)
+{
+    Cola cola;
+    int n = static_cast<int>(ts.size());
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < n; ++i)
+        cola.insertar(10000000 + i, perfiles[i % 5], ts[i]);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double msInsertar = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+    int count = 0;
+    t1 = std::chrono::high_resolution_clock::now();
+    Elemento *top = cola.verTop5(count);
+    t2 = std::chrono::high_resolution_clock::now();
+    double usTop = std::chrono::duration<double, std::micro>(t2 - t1).count();
+    delete[] top;
+
+    t1 = std::chrono::high_resolution_clock::now();
+    while (!cola.estaVacio())
+        cola.extraerMax();
+    t2 = std::chrono::high_resolution_clock::now();
+    double msExtraer = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+    std::cout << "  " << nombre << ": insertar " << msInsertar << " ms, verTop5 "
+              << usTop << " us, extraerMax (todos) " << msExtraer << " ms\n";
+}
+
+// Prueba técnica: heap binario vs cola por niveles, con llegadas casi en orden
+void compararColas()
+{
+    const char *perfiles[] = {"vip", "personal-medico", "seguridad", "discapacitados", "publico-general"};
+    std::mt19937 gen(42);
+    for (long n = 10000; n <= 10000000; n *= 10)
+    {
+        std::vector<long> ts(n);
+        for (long i = 0; i < n; ++i)
+            ts[i] = 1720406400 + i / 10 + static_cast<long>(gen() % 3);
+
+        std::cout << "[Cola] " << n << " usuarios\n";
+        medirCola<MaxHeap>("Heap binario", ts, perfiles);
+        medirCola<ColaPorNiveles>("Por niveles ", ts, perfiles);
+    }
+}
+
+// Mide insertar todo y luego extraer un 10% (patrón de la cola: muchas
+// llegadas, extracciones ocasionales) con un heap d-ario de aridad D
+template <int D>
+void medirAridad(const std::vector<EntradaHeap> &entradas)
+{
+    DaryHeap<EntradaHeap, D, MayorClave> h(1024);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (const EntradaHeap &e : entradas)
+        h.insertar(e);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double msInsertar = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+    size_t extraer = entradas.size() / 10;
+    t1 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < extraer; ++i)
+        h.extraerTope();
+    t2 = std::chrono::high_resolution_clock::now();
+    double msExtraer = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+    std::cout << "  D=" << D << ": insertar " << msInsertar << " ms ("
+              << entradas.size() / msInsertar / 1000.0 << " M/s), extraer " << extraer << ": "
+              << msExtraer << " ms (" << extraer / msExtraer / 1000.0 << " M/s)\n";
+}
+
+// Prueba técnica: throughput del heap por aridad, de 10^4 a 10^7 usuarios
+void compararAridades()
+{
+    std::mt19937 gen(42);
+    for (long n = 10000; n <= 10000000; n *= 10)
+    {
+        std::vector<EntradaHeap> entradas(n);
+        for (long i = 0; i < n; ++i)
+        {
+            entradas[i].dni = 10000000 + i;
+            entradas[i].clave = empaquetarClave(1 + gen() % 5, 1720406400 + i / 10);
+        }
+
+        std::cout << "[Heap] " << n << " usuarios (sizeof entrada: " << sizeof(EntradaHeap) << " bytes)\n";
+        medirAridad<2>(entradas);
+        medirAridad<4>(entradas);
+        medirAridad<8>(entradas);
+    }
+}
+
+// Mide insertar todos los accesos, el espacio por acceso, una consulta de
+// conteo por rango y 1000 conteos por zona en ventanas de 15 minutos
+template <typename Indice>
+void medirIndiceTiempo(const char *nombre, const std::vector<long> &ts, const int *zonas)
+{
+    Indice indice;
+    size_t n = ts.size();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < n; ++i)
+        indice.insertar(zonas[i % 5], ts[i]);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double msInsertar = std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+    t1 = std::chrono::high_resolution_clock::now();
+    long c = indice.contarRango(ts[n / 4], ts[n / 2]);
+    t2 = std::chrono::high_resolution_clock::now();
+    double usContar = std::chrono::duration<double, std::micro>(t2 - t1).count();
+
+    t1 = std::chrono::high_resolution_clock::now();
+    long zona0 = 0;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        long desde = ts[(i * 7919) % n];
+        zona0 += indice.conteoZonasEnRango(desde, desde + 900)[zonas[0]];
+    }
+    t2 = std::chrono::high_resolution_clock::now();
+    double usVentana = std::chrono::duration<double, std::micro>(t2 - t1).count() / 1000;
+
+    std::cout << "  " << nombre << ": insertar " << msInsertar << " ms ("
+              << n / msInsertar / 1000.0 << " M/s), " << double(indice.getMemoria()) / n
+              << " bytes/acceso, contarRango " << usContar << " us (" << c
+              << "), zonas en ventana " << usVentana << " us (" << zona0 << ")\n";
+}
+
+// Prueba técnica: AVL vs índice con segmento ordenado, con accesos casi en
+// orden y un 1% que llega hasta 5 minutos tarde
+void compararIndicesTiempo()
+{
+    const char *nombres[] = {"puerta-vip", "puerta-medico", "puerta-staff", "puerta-ada", "puerta-general"};
+    int zonas[5];
+    for (int z = 0; z < 5; ++z)
+        zonas[z] = RegistroZonas::global().registrar(nombres[z]);
+    std::mt19937 gen(42);
+    for (long n = 10000; n <= 10000000; n *= 10)
+    {
+        std::vector<long> ts(n);
+        for (long i = 0; i < n; ++i)
+        {
+            ts[i] = 1720406400 + i / 100;
+            if (gen() % 100 == 0)
+                ts[i] -= gen() % 300;
+        }
+
+        std::cout << "[Accesos] " << n << " accesos\n";
+        medirIndiceTiempo<ArbolAVL>("AVL          ", ts, zonas);
+        medirIndiceTiempo<IndiceTiempo>("IndiceTiempo ", ts, zonas);
+        medirIndiceTiempo<AlmacenAccesos>("Particionado ", ts, zonas);
+    }
+}
+
+// Asignador de referencia para comparar con PoolNodos: un new/delete por nodo
+template <typename T>
+struct AsignadorGlobal
+{
+    template <typename... Args>
+    T *crear(Args &&...args) { return new T(std::forward<Args>(args)...); }
+    void destruir(T *nodo) { delete nodo; }
+};
+
+// Bytes entregados por el asignador global, con los encabezados de cada
+// reserva, o -1 si no se pueden leer (solo glibc 2.33 o posterior)
+long bytesAsignados()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return static_cast<long>(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+void informarUso(const AsignadorGlobal<NodoAVL> &) {}
+
+template <typename T>
+void informarUso(const PoolNodos<T> &pool)
+{
+    UsoPool u = pool.getUso();
+    std::cout << "      pool: " << u.maxEnUso << " nodos max / " << u.capacidad << " celdas de "
+              << u.tamNodo << " bytes en " << u.bloques << " bloques (" << u.bytesReservados / 1024
+              << " KB, " << u.bloquesPaginasGrandes << " en páginas grandes)\n";
+}
+
+// Patrón de una estructura que crece y se poda: crea n nodos, destruye la
+// mitad al azar y la vuelve a crear (ahí el asignador global reparte huecos
+// dispersos), recorre los vivos en orden y destruye todo. La memoria es la
+// que entregó el asignador global con los n nodos vivos (en el pool, sus
+// bloques), contra n * sizeof(T). Con -DPOOL_PAGINAS_GRANDES los bloques de
+// 2 MiB se mapean aparte y solo aparecen en el uso del pool
+template <typename T, typename Asignador, typename Crear, typename Leer>
+void medirAsignador(const char *nombre, long n, Crear crear, Leer leer)
+{
+    Asignador asignador;
+    std::vector<T *> nodos(n);
+    std::vector<long> orden(n);
+    for (long i = 0; i < n; ++i)
+        orden[i] = i;
+    std::shuffle(orden.begin(), orden.end(), std::mt19937(7));
+    long bytesAntes = bytesAsignados();
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (long i = 0; i < n; ++i)
+        nodos[i] = crear(asignador, i);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (long i = 0; i < n / 2; ++i)
+        asignador.destruir(nodos[orden[i]]);
+    for (long i = 0; i < n / 2; ++i)
+        nodos[orden[i]] = crear(asignador, orden[i]);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    long bytesDespues = bytesAsignados();
+    long suma = 0;
+    for (long i = 0; i < n; ++i)
+        suma += leer(nodos[i]);
+    auto t3 = std::chrono::high_resolution_clock::now();
+    informarUso(asignador);
+    for (long i = 0; i < n; ++i)
+        asignador.destruir(nodos[i]);
+    auto t4 = std::chrono::high_resolution_clock::now();
+
+    auto ns = [n](std::chrono::high_resolution_clock::time_point a, std::chrono::high_resolution_clock::time_point b)
+    { return std::chrono::duration<double, std::nano>(b - a).count() / n; };
+    std::cout << "    " << nombre << ": crear " << ns(t0, t1) << " ns, podar y recrear "
+              << ns(t1, t2) << " ns, recorrer " << ns(t2, t3) << " ns, destruir " << ns(t3, t4)
+              << " ns por nodo (" << suma % 10 << ")";
+    if (bytesAntes >= 0)
+        std::cout << ", " << double(bytesDespues - bytesAntes) / n << " bytes/nodo (sizeof "
+                  << sizeof(T) << ")";
+    std::cout << "\n";
+}
+
+// Prueba técnica: PoolNodos contra new/delete por nodo, con millones de
+// nodos del AVL (la única estructura que usa el pool en el servidor)
+void compararPoolNodos()
+{
+    // Como un nodo nuevo del árbol: con su zona ya contada en el subárbol
+    auto crearAVL = [](auto &a, long i)
+    {
+        int zona = static_cast<int>(i % 5);
+        NodoAVL *n = a.crear(zona, 1720406400 + i / 100, i);
+        n->conteoZonasSub.agrandar(zona + 1);
+        ++n->conteoZonasSub[zona];
+        return n;
+    };
+    auto leerAVL = [](const NodoAVL *n)
+    { return n->timestamp; };
+
+    for (long n = 1000000; n <= 4000000; n *= 2)
+    {
+        std::cout << "[Pool] " << n << " nodos NodoAVL\n";
+        medirAsignador<NodoAVL, PoolNodos<NodoAVL>>("PoolNodos", n, crearAVL, leerAVL);
+        medirAsignador<NodoAVL, AsignadorGlobal<NodoAVL>>("new/delete", n, crearAVL, leerAVL);
+    }
+}
+
+// Encola un lote de {dni, ts}: valida cada DNI contra la tabla hash con una
+// sola búsqueda, marca en cola en el mismo paso y agrega todo al heap de una
+// vez. Devuelve un estado por item, en el mismo orden que la entrada.
+json encolarLote(const json &items)
+{
+    json estados = json::array();
+    std::vector<Elemento> lote;
+    lote.reserve(items.size());
+    long ahora = std::time(nullptr);
+
+    for (const auto &it : items)
+    {
+        if (!it.is_object() || !it.contains("dni") || !it["dni"].is_number_integer())
+        {
+            estados.push_back({{"dni", nullptr}, {"status", 400}, {"mensaje", "Item inválido"}});
+            continue;
+        }
+        long dni = it["dni"];
+        long ts = it.contains("ts") && it["ts"].is_number() ? it["ts"].get<long>() : 0;
+        // Si ts es inválido
+        if (ts <= 0 || ts < 1000000000) {
+            ts = ahora;
+        }
+        if (ts > TS_MAXIMO_CLAVE)
+        {
+            estados.push_back({{"dni", dni}, {"status", 400}, {"mensaje", "Timestamp fuera de rango (se espera en segundos)"}});
+            continue;
+        }
+
+        bool procesado = false;
+        int prioridad = 0;
+        bool existe = usuarios.modificar(dni, [&](RegistroUsuario &nodo)
+        {
+            // Un DNI repetido dentro del lote también cae aquí
+            procesado = nodo.enCola || nodo.atendido;
+            if (!procesado)
+            {
+                nodo.enCola = true;
+                prioridad = heap.perfilAPrioridadPublic(nodo.getPerfil());
+            }
+        });
+        if (!existe)
+        {
+            estados.push_back({{"dni", dni}, {"status", 404}, {"mensaje", "Usuario no registrado"}});
+            continue;
+        }
+        if (procesado)
+        {
+            estados.push_back({{"dni", dni}, {"status", 409}, {"mensaje", "Usuario ya fue procesado"}});
+            continue;
+        }
+        lote.push_back({dni, prioridad, ts});
+        estados.push_back({{"dni", dni}, {"status", 200}, {"mensaje", "Insertado en cola"}});
+    }
+
+    heap.insertarLote(lote.data(), static_cast<int>(lote.size()));
+    if (!lote.empty())
+        vistaSucia = true;
+    return estados;
+}
+
+// Extrae hasta k usuarios de la cola y los marca como atendidos, con una
+// sola búsqueda en la tabla hash por usuario
+json extraerLote(int k)
+{
+    json arr = json::array();
+    for (int i = 0; i < k && !heap.estaVacio(); ++i)
+    {
+        Elemento e = heap.extraerMax();
+        usuarios.modificar(e.dni, [](RegistroUsuario &nodo)
+        {
+            nodo.enCola = false;
+            nodo.atendido = true;
+        });
+        arr.push_back({{"dni", e.dni}, {"ts", e.ts}, {"prioridad", e.prioridad}});
+        vistaSucia = true;
+    }
+    return arr;
+}
+
 // Cargar datos desde data.json
 void cargarDatosIniciales(const std::string &path)
 {
@@ -231,19 +846,14 @@ void cargarDatosIniciales(const std::string &path)
         usuarios.insertar(u["dni"], u["perfil"]);
     }
 
-    // 2. Insertar todos los usuarios en el heap con ts aleatorio
+    // 2. Insertar todos los usuarios en el heap con ts aleatorio (mismo camino que POST /cola/batch)
+    json items = json::array();
     for (const auto &u : jdata["usuarios"])
     {
-        long dni = u["dni"];
-        std::string perfil = u["perfil"];
         long ts = 1720406400 + (std::rand() % (60 * 60 * 24)); // Un día aleatorio
-        NodoHash *nodo = usuarios.buscar(dni);
-        if (nodo && !nodo->enCola && !nodo->atendido)
-        {
-            heap.insertar(dni, perfil, ts);
-            usuarios.marcarEnCola(dni, true);
-        }
+        items.push_back({{"dni", u["dni"]}, {"ts", ts}});
     }
+    encolarLote(items);
 
     // 3. Vaciar el heap (simula operaciones de extracción)
     while (!heap.estaVacio())
@@ -253,8 +863,10 @@ void cargarDatosIniciales(const std::string &path)
         usuarios.marcarAtendido(e.dni, true);
     }
 
-    // 4. Insertar en AVL un acceso por cada usuario, zona según perfil, ts lineal por perfil (7 min) + minutos aleatorios
-    long base_ts = 1720406400; // inicio del día
+    // 4. Insertar en el índice un acceso por cada usuario, zona según perfil, ts lineal por perfil (7 min) + minutos aleatorios.
+    // Los accesos caen en el día anterior, dentro de la retención: con datos
+    // más viejos el primer acceso real los descartaría
+    long base_ts = (static_cast<long>(std::time(nullptr)) / 86400 - 1) * 86400; // inicio de ayer
     int i_vip = 0, i_med = 0, i_seg = 0, i_disc = 0, i_pub = 0;
     const long intervalo = 7 * 60; // 7 minutos
 
@@ -266,41 +878,64 @@ void cargarDatosIniciales(const std::string &path)
         if (perfil == "vip")
         {
             ts = base_ts + i_vip * intervalo + min_offset * 60;
-            arbol.insertar("puerta-vip", ts);
+            accesos.insertar("puerta-vip", ts);
             ++i_vip;
         }
         else if (perfil == "personal-medico")
         {
             ts = base_ts + i_med * intervalo + min_offset * 60;
-            arbol.insertar("puerta-medico", ts);
+            accesos.insertar("puerta-medico", ts);
             ++i_med;
         }
         else if (perfil == "seguridad")
         {
             ts = base_ts + i_seg * intervalo + min_offset * 60;
-            arbol.insertar("puerta-staff", ts);
+            accesos.insertar("puerta-staff", ts);
             ++i_seg;
         }
         else if (perfil == "discapacitados")
         {
             ts = base_ts + i_disc * intervalo + min_offset * 60;
-            arbol.insertar("puerta-ada", ts);
+            accesos.insertar("puerta-ada", ts);
             ++i_disc;
         }
         else if (perfil == "publico-general")
         {
             ts = base_ts + i_pub * intervalo + min_offset * 60;
-            arbol.insertar("puerta-general", ts);
+            accesos.insertar("puerta-general", ts);
             ++i_pub;
         }
     }
 }
 
-int main()
+// Uso: AppBackend            servidor en el puerto 18080
+//      AppBackend --test     pruebas de comportamiento (código de salida 1 si falla alguna)
+//      AppBackend --bench    pruebas técnicas de tiempos y memoria
+int main(int argc, char *argv[])
 {
+    std::string modo = argc > 1 ? argv[1] : "";
+    if (modo == "--test")
+        return ejecutarPruebas() == 0 ? 0 : 1;
+    if (modo == "--bench")
+    {
+        cargarDatosInicialesPruebaTecnica("data.json");
+        compararTablasHash();
+        compararHashConcurrente();
+        compararColas();
+        compararAridades();
+        compararIndicesTiempo();
+        compararPoolNodos();
+        return 0;
+    }
+
     Server svr;
-     cargarDatosIniciales("data.json");
-    //cargarDatosInicialesPruebaTecnica("data.json");
+    cargarDatosIniciales("data.json");
+
+    // Desde aquí las estructuras solo se modifican en el hilo escritor, así
+    // que el servidor puede atender con varios hilos
+    escritor.iniciar(publicarVista);
+    svr.new_task_queue = []
+    { return new ThreadPool(std::max(8u, 2 * std::thread::hardware_concurrency())); };
 
     // Middleware CORS
     svr.set_pre_routing_handler([](const Request &req, Response &res)
@@ -316,21 +951,65 @@ int main()
 
     // ---------------- HASH TABLE ----------------
 
-    // GET /usuarios → usuarios no atendidos ni en cola
-    svr.Get("/usuarios", [](const Request &, Response &res)
+    // GET /usuarios → usuarios no atendidos ni en cola (índice de pendientes)
+    // GET /usuarios?perfil=vip&estado=pendiente&limit=50&cursor=... → página
+    // filtrada en el servidor: {"usuarios": [...], "cursor": siguiente o null}
+    svr.Get("/usuarios", [](const Request &req, Response &res)
             {
-        json arr = json::array();
-        for (int i = 0; i < usuarios.getTam(); ++i) {
-            NodoHash* n = usuarios.getBucket(i);
-            while (n) {
-                if (!n->enCola && !n->atendido) {
-                    arr.push_back({ {"dni", n->dni}, {"perfil", n->perfil} });
+        if (req.has_param("perfil") || req.has_param("estado") ||
+            req.has_param("limit") || req.has_param("cursor")) {
+            EstadoUsuario estado = ESTADO_PENDIENTE;
+            if (req.has_param("estado")) {
+                std::string e = req.get_param_value("estado");
+                if (e == "pendiente") estado = ESTADO_PENDIENTE;
+                else if (e == "en_cola") estado = ESTADO_EN_COLA;
+                else if (e == "atendido") estado = ESTADO_ATENDIDO;
+                else {
+                    res.status = 400;
+                    res.set_content("Parámetro estado debe ser pendiente, en_cola o atendido", "text/plain");
+                    return;
                 }
-                n = n->siguiente;
             }
+            int limit = 50;
+            if (req.has_param("limit")) {
+                limit = std::atoi(req.get_param_value("limit").c_str());
+            }
+            if (limit <= 0 || limit > 1000) {
+                res.status = 400;
+                res.set_content("Parámetro limit debe estar entre 1 y 1000", "text/plain");
+                return;
+            }
+            // El cursor es el id global (en hexadecimal) con el que sigue la lista
+            uint32_t desde = 0;
+            if (req.has_param("cursor")) {
+                desde = static_cast<uint32_t>(std::strtoul(req.get_param_value("cursor").c_str(), nullptr, 16));
+            }
+            std::string perfil = req.has_param("perfil") ? req.get_param_value("perfil") : "";
+
+            json arr = json::array();
+            long siguiente = usuarios.listar(estado, perfil.empty() ? nullptr : &perfil, desde, limit,
+                                             [&](const RegistroUsuario &n) {
+                arr.push_back({ {"dni", n.dni}, {"perfil", n.getPerfil()} });
+            });
+            char cursor[16];
+            std::snprintf(cursor, sizeof(cursor), "%lx", siguiente);
+            json j = {{"usuarios", arr}, {"cursor", siguiente < 0 ? json(nullptr) : json(cursor)}};
+            res.set_content(j.dump(), "application/json");
+            return;
         }
+
+        json arr = json::array();
+        usuarios.recorrerPendientes([&](const RegistroUsuario &n) {
+            arr.push_back({ {"dni", n.dni}, {"perfil", n.getPerfil()} });
+        });
         res.set_content(arr.dump(), "application/json"); });
 
+    // GET /usuarios/cantidad → registrados y pendientes, sin recorrer nada
+    svr.Get("/usuarios/cantidad", [](const Request &, Response &res)
+            {
+        json j = {{"total", usuarios.getCantidad()}, {"pendientes", usuarios.getCantidadPendientes()}};
+        res.set_content(j.dump(), "application/json"); });
+
     // POST /usuario → registrar nuevo usuario
     svr.Post("/usuario", [](const Request &req, Response &res)
              {
@@ -344,13 +1023,13 @@ int main()
         long dni = j["dni"];
         std::string perfil = j["perfil"];
 
-        if (usuarios.validar(dni)) {
+        // Solo toca la tabla: no pasa por el hilo escritor
+        if (!usuarios.insertar(dni, perfil)) {
             res.status = 409;
             res.set_content("Usuario ya existe", "text/plain");
             return;
         }
 
-        usuarios.insertar(dni, perfil);
         res.status = 201;
         res.set_content("Usuario creado", "text/plain"); });
 
@@ -367,30 +1046,30 @@ int main()
         auto j = json::parse(req.body);
         std::string nuevoPerfil = j["perfil"];
 
-        NodoHash* nodo = usuarios.buscar(dni);
-        if (!nodo) {
+        bool encontrado = false;
+        escritor.ejecutar([&] {
+            encontrado = usuarios.cambiarPerfil(dni, nuevoPerfil);
+            if (!encontrado)
+                return;
+            // Si está en el heap, actualizar prioridad (y el perfil de la vista)
+            if (heap.actualizarPrioridadDni(dni, heap.perfilAPrioridadPublic(nuevoPerfil)))
+                vistaSucia = true;
+        });
+        if (!encontrado) {
             res.status = 404;
             res.set_content("Usuario no encontrado", "text/plain");
             return;
         }
 
-        nodo->perfil = nuevoPerfil;
-
-        // Si está en el heap, actualizar prioridad
-        int idx = heap.buscarIndice(dni);
-        if (idx >= 0) {
-            heap.actualizarPrioridad(idx, heap.perfilAPrioridadPublic(nuevoPerfil));
-        }
-
         res.set_content("Perfil actualizado", "text/plain"); });
 
     // GET /usuario/{dni} → validación de existencia
     svr.Get(R"(/usuario/(\d+))", [](const Request &req, Response &res)
             {
         long dni = std::stol(req.matches[1]);
-        NodoHash* nodo = usuarios.buscar(dni);
-        if (nodo) {
-            res.set_content(json({{"valid", true}, {"perfil", nodo->perfil}}).dump(), "application/json");
+        std::string perfil;
+        if (usuarios.obtenerPerfil(dni, perfil)) {
+            res.set_content(json({{"valid", true}, {"perfil", perfil}}).dump(), "application/json");
         } else {
             res.set_content(json({{"valid", false}}).dump(), "application/json");
         } });
@@ -407,32 +1086,68 @@ int main()
         if (ts <= 0 || ts < 1000000000) {
             ts = std::time(nullptr);
         }
-        NodoHash* nodo = usuarios.buscar(dni);
-        if (!nodo) {
+        if (ts > TS_MAXIMO_CLAVE) {
+            res.status = 400;
+            res.set_content("Timestamp fuera de rango (se espera en segundos)", "text/plain");
+            return;
+        }
+        int status = 200;
+        escritor.ejecutar([&] {
+            std::string perfil;
+            bool existe = usuarios.modificar(dni, [&](RegistroUsuario &nodo) {
+                if (nodo.enCola || nodo.atendido) {
+                    status = 409;
+                    return;
+                }
+                nodo.enCola = true;
+                perfil = nodo.getPerfil();
+            });
+            if (!existe)
+                status = 404;
+            if (status == 200) {
+                heap.insertar(dni, perfil, ts);
+                vistaSucia = true;
+            }
+        });
+        if (status == 404) {
             res.status = 404;
             res.set_content("Usuario no registrado", "text/plain");
             return;
         }
-        if (nodo->enCola || nodo->atendido) {
+        if (status == 409) {
             res.status = 409;
             res.set_content("Usuario ya fue procesado", "text/plain");
             return;
         }
-        heap.insertar(dni, nodo->perfil, ts);
-        usuarios.marcarEnCola(dni, true);
         res.set_content("Insertado en cola", "text/plain"); });
 
-    // GET /cola/top5 → ver los siguientes 5 por prioridad, con perfil
-    svr.Get("/cola/top5", [&](const Request &, Response &res)
-            {
-        int count = 0;
-        Elemento* top = heap.verTop5(count);
+    // Serializa los k primeros de la cola, con perfil. Hasta TOP_COLA salen de
+    // la vista publicada; más allá se recorre el heap con lock compartido
+    auto colaTop = [](int k)
+    {
         json arr = json::array();
+        if (k <= VistaPublicada::TOP_COLA) {
+            auto v = std::atomic_load(&vistaActual);
+            for (int i = 0; i < k && i < (int)v->cola.size(); ++i) {
+                const FilaCola &f = v->cola[i];
+                arr.push_back({
+                    {"dni", f.dni},
+                    {"perfil", f.perfil},
+                    {"prioridad", f.prioridad},
+                    {"ts", f.ts}
+                });
+            }
+            return arr;
+        }
+
+        std::shared_lock<std::shared_mutex> lk(escritor.vista());
+        int count = 0;
+        Elemento* top = heap.verTopK(k, count);
 
         for (int i = 0; i < count; ++i) {
             long dni = top[i].dni;
-            NodoHash* nodo = usuarios.buscar(dni);
-            std::string perfil = nodo ? nodo->perfil : "-";
+            std::string perfil = "-";
+            usuarios.obtenerPerfil(dni, perfil);
 
             arr.push_back({
                 {"dni", dni},
@@ -443,20 +1158,69 @@ int main()
         }
 
         delete[] top;
-        res.set_content(arr.dump(), "application/json"); });
+        return arr;
+    };
+
+    // POST /cola/batch → insertar un lote [{dni, ts}, ...] con estado por item
+    svr.Post("/cola/batch", [](const Request &req, Response &res)
+             {
+        if (req.body.empty()) {
+            res.status = 400;
+            res.set_content("Body vacío", "text/plain");
+            return;
+        }
+
+        auto j = json::parse(req.body, nullptr, false);
+        if (j.is_discarded() || !j.is_array()) {
+            res.status = 400;
+            res.set_content("Se esperaba un arreglo de {dni, ts}", "text/plain");
+            return;
+        }
+
+        json estados;
+        escritor.ejecutar([&] { estados = encolarLote(j); });
+        res.set_content(estados.dump(), "application/json"); });
+
+    // GET /cola/top5 → ver los siguientes 5 por prioridad, con perfil
+    svr.Get("/cola/top5", [&](const Request &, Response &res)
+            { res.set_content(colaTop(5).dump(), "application/json"); });
+
+    // GET /cola/top?k=N → ver los siguientes N por prioridad, con perfil
+    svr.Get("/cola/top", [&](const Request &req, Response &res)
+            {
+        int k = 5;
+        if (req.has_param("k")) {
+            k = std::atoi(req.get_param_value("k").c_str());
+        }
+        if (k <= 0) {
+            res.status = 400;
+            res.set_content("Parámetro k debe ser positivo", "text/plain");
+            return;
+        }
+        res.set_content(colaTop(k).dump(), "application/json"); });
 
     // POST /cola/extract → extraer al siguiente y marcar como atendido
-    svr.Post("/cola/extract", [](const Request &, Response &res)
+    // POST /cola/extract?n=K → extraer hasta K de una vez (arreglo JSON)
+    svr.Post("/cola/extract", [](const Request &req, Response &res)
              {
-        if (heap.estaVacio()) {
+        int n = 1;
+        bool lote = req.has_param("n");
+        if (lote) {
+            n = std::atoi(req.get_param_value("n").c_str());
+            if (n <= 0) {
+                res.status = 400;
+                res.set_content("Parámetro n debe ser positivo", "text/plain");
+                return;
+            }
+        }
+
+        json arr;
+        escritor.ejecutar([&] { arr = extraerLote(n); });
+        if (arr.empty()) {
             res.status = 204;
             return;
         }
-
-        Elemento e = heap.extraerMax();
-        usuarios.marcarEnCola(e.dni, false);
-        usuarios.marcarAtendido(e.dni, true);
-        res.set_content(json({{"dni", e.dni}, {"ts", e.ts}, {"prioridad", e.prioridad}}).dump(), "application/json"); });
+        res.set_content((lote ? arr : arr[0]).dump(), "application/json"); });
 
     // PUT /cola/update → cambiar prioridad
     svr.Put("/cola/update", [](const Request &req, Response &res)
@@ -465,14 +1229,18 @@ int main()
         long dni = j["dni"];
         std::string nuevoPerfil = j["nuevo_perfil"];
 
-        int idx = heap.buscarIndice(dni);
-        if (idx < 0) {
+        bool enCola = false;
+        escritor.ejecutar([&] {
+            enCola = heap.actualizarPrioridadDni(dni, heap.perfilAPrioridadPublic(nuevoPerfil));
+            if (enCola)
+                vistaSucia = true;
+        });
+        if (!enCola) {
             res.status = 404;
             res.set_content("No está en cola", "text/plain");
             return;
         }
 
-        heap.actualizarPrioridad(idx, heap.perfilAPrioridadPublic(nuevoPerfil));
         res.set_content("Prioridad actualizada", "text/plain"); });
 
     // ---------------- AVL TREE ----------------
@@ -480,8 +1248,58 @@ int main()
     // POST /acceso → registrar acceso a zona (no afecta heap)
     svr.Post("/acceso", [](const Request &req, Response &res)
              {
-        auto j = json::parse(req.body);
-        arbol.insertar(j["zona"], j["ts"]);
+        auto j = json::parse(req.body, nullptr, false);
+        if (j.is_discarded() || !j.is_object() || !j.contains("ts") || !j["ts"].is_number_integer() ||
+            !j.contains("zona") || !j["zona"].is_string()) {
+            res.status = 400;
+            res.set_content("Se esperaba {zona, ts}", "text/plain");
+            return;
+        }
+        const std::string &zona = j["zona"].get_ref<const std::string &>();
+        if (zona.empty() || zona.size() > RegistroZonas::MAX_LARGO_NOMBRE) {
+            res.status = 400;
+            res.set_content("Nombre de zona vacío o demasiado largo", "text/plain");
+            return;
+        }
+        long ts = j["ts"];
+        // Un timestamp adelantado (por ejemplo en milisegundos) movería el
+        // inicio de la retención y descartaría todo lo anterior
+        if (ts > static_cast<long>(std::time(nullptr)) + MARGEN_FUTURO_ACCESOS) {
+            res.status = 400;
+            res.set_content("Timestamp posterior a la hora del servidor", "text/plain");
+            return;
+        }
+        // Los ids de zona no se liberan: un acceso que igual se rechazaría
+        // no debe registrar su zona
+        bool admitido;
+        {
+            std::shared_lock<std::shared_mutex> lk(escritor.vista());
+            admitido = accesos.admite(ts);
+        }
+        if (!admitido) {
+            res.status = 422;
+            res.set_content("Acceso fuera del período de retención", "text/plain");
+            return;
+        }
+        // La zona se pasa a id acá, fuera del escritor: el índice solo
+        // recibe el id y no copia el nombre
+        int zonaId = RegistroZonas::global().registrar(zona);
+        if (zonaId < 0) {
+            res.status = 422;
+            res.set_content("No se pueden registrar más zonas", "text/plain");
+            return;
+        }
+        bool registrado = false;
+        escritor.ejecutar([&] {
+            registrado = accesos.insertar(zonaId, ts);
+            if (registrado)
+                vistaSucia = true;
+        });
+        if (!registrado) {
+            res.status = 422;
+            res.set_content("Acceso fuera del período de retención", "text/plain");
+            return;
+        }
         res.set_content("Acceso registrado", "text/plain"); });
 
     // GET /accesos/rango?inicio=...&fin=...
@@ -496,18 +1314,185 @@ int main()
         long ini = std::stol(req.get_param_value("inicio"));
         long fin = std::stol(req.get_param_value("fin"));
 
-        auto vec = arbol.rangoTiempos(ini, fin);
+        // Con limit, cursor u offset responde una página:
+        // {"accesos": [...], "cursor": siguiente o null, "total": accesos en el rango}.
+        // El cursor es la clave del último acceso entregado: "timestamp.secuencia".
+        // offset salta esa cantidad de accesos del rango sin recorrerlos
+        if (req.has_param("limit") || req.has_param("cursor") || req.has_param("offset")) {
+            int limit = 100;
+            if (req.has_param("limit")) {
+                limit = std::atoi(req.get_param_value("limit").c_str());
+            }
+            if (limit <= 0 || limit > 1000) {
+                res.status = 400;
+                res.set_content("Parámetro limit debe estar entre 1 y 1000", "text/plain");
+                return;
+            }
+            long desdeTs = ini, desdeSeq = -1;
+            if (req.has_param("cursor") &&
+                std::sscanf(req.get_param_value("cursor").c_str(), "%ld.%ld", &desdeTs, &desdeSeq) != 2) {
+                res.status = 400;
+                res.set_content("Cursor inválido", "text/plain");
+                return;
+            }
+            if (desdeTs < ini) {
+                desdeTs = ini;
+                desdeSeq = -1;
+            }
+            long offset = 0;
+            if (req.has_param("offset")) {
+                if (req.has_param("cursor")) {
+                    res.status = 400;
+                    res.set_content("Usar cursor u offset, no ambos", "text/plain");
+                    return;
+                }
+                offset = std::atol(req.get_param_value("offset").c_str());
+                if (offset < 0) {
+                    res.status = 400;
+                    res.set_content("Parámetro offset inválido", "text/plain");
+                    return;
+                }
+            }
+
+            std::vector<Acceso> pagina;
+            json arr = json::array();
+            json cursor = nullptr;
+            long total;
+            {
+                std::shared_lock<std::shared_mutex> lk(escritor.vista());
+                total = accesos.contarRango(ini, fin);
+                if (offset > 0 && total > 0) {
+                    // La página arranca después del acceso anterior al offset
+                    Acceso previo;
+                    accesos.seleccionar(accesos.posicionDesde(ini) + std::min(offset, total) - 1, previo);
+                    desdeTs = previo.timestamp;
+                    desdeSeq = previo.secuencia;
+                }
+                bool hayMas = accesos.rangoPagina(desdeTs, desdeSeq, fin, limit, pagina);
+                for (const Acceso &a : pagina) {
+                    arr.push_back({{"zona", accesos.nombreZona(a.zonaId)}, {"ts", a.timestamp}});
+                }
+                if (hayMas) {
+                    cursor = std::to_string(pagina.back().timestamp) + "." + std::to_string(pagina.back().secuencia);
+                }
+            }
+            res.set_content(json({{"accesos", arr}, {"cursor", cursor}, {"total", total}}).dump(), "application/json");
+            return;
+        }
+
+        // Sin paginar: el arreglo se escribe por partes (chunked) a medida que
+        // se recorre el índice, sin armar el resultado completo en memoria.
+        // Cada parte toma la vista solo mientras serializa sus filas y retoma
+        // desde la clave de la última fila, así un cliente lento no frena
+        // al hilo escritor
+        struct Recorrido
+        {
+            long ts;
+            long seq;
+            bool primeraFila;
+        };
+        auto estado = std::make_shared<Recorrido>(Recorrido{ini, -1, true});
+        res.set_chunked_content_provider("application/json", [estado, fin](size_t, DataSink &sink)
+                                         {
+            const int FILAS_POR_PARTE = 256;
+            std::string buf;
+            if (estado->primeraFila && estado->seq == -1)
+                buf = "[";
+            bool terminado;
+            {
+                std::shared_lock<std::shared_mutex> lk(escritor.vista());
+                IteradorAccesos it = accesos.desde(estado->ts, estado->seq);
+                for (int i = 0; i < FILAS_POR_PARTE && it.valido() && it->timestamp <= fin; ++i, ++it) {
+                    if (!estado->primeraFila)
+                        buf += ',';
+                    estado->primeraFila = false;
+                    buf += "{\"zona\":";
+                    buf += json(accesos.nombreZona(it->zonaId)).dump();
+                    buf += ",\"ts\":";
+                    buf += std::to_string(it->timestamp);
+                    buf += '}';
+                    estado->ts = it->timestamp;
+                    estado->seq = it->secuencia;
+                }
+                terminado = !it.valido() || it->timestamp > fin;
+            }
+            if (terminado)
+                buf += ']';
+            if (!buf.empty() && !sink.write(buf.data(), buf.size()))
+                return false;
+            if (terminado)
+                sink.done();
+            return true; }); });
+
+    // GET /accesos/conteo?inicio=...&fin=... → {"cantidad": N}. O(log n): no
+    // recorre los accesos del rango
+    svr.Get("/accesos/conteo", [](const Request &req, Response &res)
+            {
+        if (!req.has_param("inicio") || !req.has_param("fin")) {
+            res.status = 400;
+            res.set_content("Parámetros inicio y fin requeridos", "text/plain");
+            return;
+        }
+        long ini = std::stol(req.get_param_value("inicio"));
+        long fin = std::stol(req.get_param_value("fin"));
+        long cantidad;
+        {
+            std::shared_lock<std::shared_mutex> lk(escritor.vista());
+            cantidad = accesos.contarRango(ini, fin);
+        }
+        res.set_content(json({{"cantidad", cantidad}}).dump(), "application/json"); });
+
+    // GET /accesos/zona_top[?inicio=...&fin=...]. Sin ventana sale de la vista
+    // publicada; con ventana resta los conteos por zona acumulados hasta cada extremo
+    svr.Get("/accesos/zona_top", [](const Request &req, Response &res)
+            {
+        if (!req.has_param("inicio") && !req.has_param("fin")) {
+            res.set_content(std::atomic_load(&vistaActual)->zonaTop, "text/plain");
+            return;
+        }
+        if (!req.has_param("inicio") || !req.has_param("fin")) {
+            res.status = 400;
+            res.set_content("Parámetros inicio y fin requeridos", "text/plain");
+            return;
+        }
+        long ini = std::stol(req.get_param_value("inicio"));
+        long fin = std::stol(req.get_param_value("fin"));
+        std::string zona;
+        {
+            std::shared_lock<std::shared_mutex> lk(escritor.vista());
+            zona = accesos.zonaMasEntradas(ini, fin);
+        }
+        res.set_content(zona, "text/plain"); });
+
+    // GET /accesos/zonas_top?k=N → las N zonas con mas accesos y su conteo
+    svr.Get("/accesos/zonas_top", [](const Request &req, Response &res)
+            {
+        int k = 5;
+        if (req.has_param("k")) {
+            k = std::atoi(req.get_param_value("k").c_str());
+        }
+        if (k <= 0) {
+            res.status = 400;
+            res.set_content("Parámetro k debe ser positivo", "text/plain");
+            return;
+        }
+
         json arr = json::array();
-        for (auto* n : vec) {
-            arr.push_back({{"zona", n->zona}, {"ts", n->timestamp}});
+        if (k <= VistaPublicada::TOP_ZONAS) {
+            auto v = std::atomic_load(&vistaActual);
+            for (int i = 0; i < k && i < (int)v->zonas.size(); ++i) {
+                arr.push_back({{"zona", v->zonas[i].first}, {"conteo", v->zonas[i].second}});
+            }
+        } else {
+            std::shared_lock<std::shared_mutex> lk(escritor.vista());
+            for (const auto &z : accesos.zonasTop(k)) {
+                arr.push_back({{"zona", z.first}, {"conteo", z.second}});
+            }
         }
         res.set_content(arr.dump(), "application/json"); });
 
-    // GET /accesos/zona_top
-    svr.Get("/accesos/zona_top", [](const Request &, Response &res)
-            { res.set_content(arbol.zonaMasEntradas(), "text/plain"); });
-
     std::cout << "Servidor escuchando en http://localhost:18080\n";
     svr.listen("0.0.0.0", 18080);
+    escritor.detener();
     return 0;
 }
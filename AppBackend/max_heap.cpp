@@ -1,18 +1,10 @@
 #include "max_heap.h"
 #include <string>
 
-// Constructor / Destructor
+// Constructor: el heap d-ario avisa cada movimiento al índice de posiciones
 MaxHeap::MaxHeap(int cap_inicial)
-    : capacidad(cap_inicial), tamanio(0)
+    : heap(cap_inicial, MayorClave(), RegistrarPosicion{&posiciones})
 {
-    heap = new Elemento[capacidad];
-}
-
-// Destructor: libera la memoria dinámica
-// Se asegura de liberar el array dinámico que contiene los elementos del heap
-MaxHeap::~MaxHeap()
-{
-    delete[] heap;
 }
 
 // Convierte perfil a valor de prioridad
@@ -31,166 +23,87 @@ int MaxHeap::perfilAPrioridad(const std::string &perfil) const
     return 0; // desconocido o perfil inválido
 }
 
-// Duplicar la capacidad del array cuando está lleno
-// Crea un nuevo array con el doble de capacidad, copia los elementos existentes y libera el antiguo
-// Esta función se llama automáticamente cuando el heap está lleno
-void MaxHeap::expandir()
-{
-    int nuevaCap = capacidad * 2;
-    Elemento *nuevo = new Elemento[nuevaCap];
-    for (int i = 0; i < tamanio; ++i)
-    {
-        nuevo[i] = heap[i];
-    }
-    delete[] heap; // Aquí se libera la memoria del array antiguo para evitar fugas de memoria
-    heap = nuevo;
-    capacidad = nuevaCap;
-}
-
 void MaxHeap::insertar(long dni, const std::string &perfil, long ts)
 {
-    if (tamanio == capacidad)
-    {
-        expandir();
-    }
-    Elemento e;
+    EntradaHeap e;
     e.dni = dni;
-    e.prioridad = perfilAPrioridad(perfil);
-    e.ts = ts;
-    heap[tamanio] = e;
-    heapifyUp(tamanio);
-    ++tamanio;
+    e.clave = empaquetarClave(perfilAPrioridad(perfil), ts);
+    heap.insertar(e);
 }
 
-// Compara SOLO por prioridad
-bool mayorPrioridad(const Elemento &a, const Elemento &b)
+void MaxHeap::insertarLote(const Elemento *lote, int n)
 {
-    return a.prioridad > b.prioridad;
-}
-
-void MaxHeap::heapifyUp(int i)
-{
-    while (i > 0)
+    // Con pocos elementos nuevos conviene subir cada uno (O(m log n));
+    // desde un cuarto del heap, agregar todo y reconstruir (O(n + m)) es más barato
+    bool floyd = n * 4 >= heap.getTamanio();
+    for (int i = 0; i < n; ++i)
     {
-        int p = padre(i);
-        if (mayorPrioridad(heap[i], heap[p]))
-        {
-            Elemento aux = heap[i];
-            heap[i] = heap[p];
-            heap[p] = aux;
-            i = p;
-        }
+        EntradaHeap e;
+        e.dni = lote[i].dni;
+        e.clave = empaquetarClave(lote[i].prioridad, lote[i].ts);
+        if (floyd)
+            heap.agregarSinOrden(e);
         else
-        {
-            break;
-        }
+            heap.insertar(e);
     }
+    if (floyd)
+        heap.reconstruir();
 }
 
-void MaxHeap::heapifyDown(int i)
+Elemento MaxHeap::extraerMax()
 {
-    while (true)
+    if (heap.estaVacio())
     {
-        int mayor = i;
-        int l = izq(i);
-        int r = der(i);
-        if (l < tamanio && mayorPrioridad(heap[l], heap[mayor]))
-        {
-            mayor = l;
-        }
-        if (r < tamanio && mayorPrioridad(heap[r], heap[mayor]))
-        {
-            mayor = r;
-        }
-        if (mayor != i)
-        {
-            Elemento aux = heap[i];
-            heap[i] = heap[mayor];
-            heap[mayor] = aux;
-            i = mayor;
-        }
-        else
-        {
-            break;
-        }
+        return {0, 0, 0}; // dni = 0 prioridad = 0 ts = 0
     }
+    Elemento root = desempaquetar(heap.extraerTope()); // el nodo con mayor prioridad
+    posiciones.eliminar(root.dni);
+    return root;
 }
 
-Elemento MaxHeap::extraerMax()
+bool MaxHeap::actualizarPrioridadDni(long dni, int nuevaPrio)
 {
-    if (tamanio == 0)
-    {
-        return {0, 0, 0}; // dni = 0 prioridad = 0 ts = 0
-    }
-    Elemento root = heap[0];     // Extrae la raíz: el nodo con mayor prioridad
-    heap[0] = heap[tamanio - 1]; // Reemplaza la raíz con el último elemento
-    --tamanio;
-    heapifyDown(0);
-    return root; // Retorna el elemento extraído
+    int idx = posiciones.obtener(dni);
+    if (idx < 0)
+        return false;
+    actualizarPrioridad(idx, nuevaPrio);
+    return true;
+}
+
+// Igual que extraerMax pero en una posición cualquiera: el último elemento
+// ocupa el hueco y se reordena hacia arriba o hacia abajo según corresponda
+bool MaxHeap::eliminarPorDni(long dni)
+{
+    int idx = posiciones.obtener(dni);
+    if (idx < 0)
+        return false;
+    posiciones.eliminar(dni);
+    heap.eliminarEn(idx);
+    return true;
 }
 
 void MaxHeap::actualizarPrioridad(int idx, int nuevaPrio)
 {
-    if (idx < 0 || idx >= tamanio)
+    if (idx < 0 || idx >= heap.getTamanio())
         return;
-    int antigua = heap[idx].prioridad;
-    heap[idx].prioridad = nuevaPrio;
-    if (nuevaPrio > antigua)
-    {
-        heapifyUp(idx);
-    }
-    else
-    {
-        heapifyDown(idx);
-    }
+    // Se conserva el ts (la mitad baja de la clave), solo cambia la prioridad
+    EntradaHeap &e = heap.en(idx);
+    e.clave = (static_cast<uint64_t>(static_cast<uint32_t>(nuevaPrio)) << 32) | (e.clave & 0xFFFFFFFFu);
+    heap.reubicar(idx);
 }
 
-Elemento *MaxHeap::verTop5(int &outCount) const
+// Top-k sin copiar el heap (ver DaryHeap::verTopK)
+Elemento *MaxHeap::verTopK(int k, int &outCount) const
 {
-    int n = (tamanio < 5 ? tamanio : 5);
-    Elemento *copia = new Elemento[tamanio];
-    for (int i = 0; i < tamanio; ++i)
-    {
-        copia[i] = heap[i];
-    }
-
-    // Selection sort SOLO por prioridad para los primeros n elementos
+    int n = (heap.getTamanio() < k ? heap.getTamanio() : k);
+    if (n < 0)
+        n = 0;
+    EntradaHeap *entradas = new EntradaHeap[n];
+    n = heap.verTopK(n, entradas);
+    Elemento *top = new Elemento[n];
     for (int i = 0; i < n; ++i)
-    {
-        int maxIdx = i;
-        for (int j = i + 1; j < tamanio; ++j)
-        {
-            if (copia[j].prioridad > copia[maxIdx].prioridad)
-            {
-                maxIdx = j;
-            }
-        }
-        if (maxIdx != i)
-        {
-            Elemento temp = copia[i];
-            copia[i] = copia[maxIdx];
-            copia[maxIdx] = temp;
-        }
-    }
-
-    Elemento *top5 = new Elemento[n];
-    for (int i = 0; i < n; ++i)
-    {
-        top5[i] = copia[i];
-    }
-    delete[] copia;
+        top[i] = desempaquetar(entradas[i]);
+    delete[] entradas;
     outCount = n;
-    return top5;
-}
-
-int MaxHeap::buscarIndice(long dni) const
-{
-    for (int i = 0; i < tamanio; ++i)
-    {
-        if (heap[i].dni == dni)
-        {
-            return i;
-        }
-    }
-    return -1;
+    return top;
 }
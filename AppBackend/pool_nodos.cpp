@@ -0,0 +1,61 @@
+#include "pool_nodos.h"
+#if defined(POOL_PAGINAS_GRANDES) && defined(__linux__)
+#include <cstdint>
+#include <sys/mman.h>
+#define PAGINAS_GRANDES_LINUX
+#endif
+
+static const size_t LINEA_CACHE = 64;
+
+#ifdef PAGINAS_GRANDES_LINUX
+// Las páginas grandes transparentes solo cubren rangos alineados a 2 MiB:
+// se mapea el doble y se recortan los sobrantes de cada lado
+static void *mapearAlineado(size_t bytes)
+{
+    void *p = mmap(nullptr, 2 * bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        throw std::bad_alloc();
+    uintptr_t inicio = reinterpret_cast<uintptr_t>(p);
+    uintptr_t alineado = (inicio + bytes - 1) & ~(static_cast<uintptr_t>(bytes) - 1);
+    if (alineado > inicio)
+        munmap(p, alineado - inicio);
+    munmap(reinterpret_cast<void *>(alineado + bytes), inicio + bytes - alineado);
+    return reinterpret_cast<void *>(alineado);
+}
+#endif
+
+void *reservarBloquePool(size_t bytes, bool &paginasGrandes)
+{
+    paginasGrandes = false;
+#ifdef PAGINAS_GRANDES_LINUX
+    if (bytes == TAM_PAGINA_GRANDE)
+    {
+        void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+        {
+            paginasGrandes = true;
+            return p;
+        }
+        // Sin páginas reservadas en hugetlbfs; si no hay THP quedan normales
+        p = mapearAlineado(bytes);
+        madvise(p, bytes, MADV_HUGEPAGE);
+        return p;
+    }
+#endif
+    return ::operator new(bytes, std::align_val_t(LINEA_CACHE));
+}
+
+void liberarBloquePool(void *p, size_t bytes, bool paginasGrandes)
+{
+    (void)bytes;
+    (void)paginasGrandes;
+#ifdef PAGINAS_GRANDES_LINUX
+    if (bytes == TAM_PAGINA_GRANDE)
+    {
+        munmap(p, bytes);
+        return;
+    }
+#endif
+    ::operator delete(p, std::align_val_t(LINEA_CACHE));
+}
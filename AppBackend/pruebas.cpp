@@ -0,0 +1,53 @@
+#include "pruebas.h"
+#include <iostream>
+
+const char *const PERFILES[NUM_PERFILES] = {"desconocido", "publico-general", "discapacitados",
+                                            "seguridad", "personal-medico", "vip"};
+
+void comprobar(bool condicion, const std::string &detalle)
+{
+    if (!condicion)
+        throw FallaPrueba{detalle};
+}
+
+int ejecutarPruebas()
+{
+    struct Prueba
+    {
+        const char *nombre;
+        void (*ejecutar)();
+    };
+    const Prueba pruebas[] = {
+        {"IndiceDni", probarIndiceDni},
+        {"DaryHeap", probarDaryHeap},
+        {"MaxHeap", probarMaxHeap},
+        {"ColaPorNiveles", probarColaPorNiveles},
+        {"TablaHash (pendientes)", probarPendientesTablaHash},
+        {"TablaHashConcurrente", probarTablaHashConcurrente},
+        {"TablaHashConcurrente (listar)", probarListadoTablaConcurrente},
+        {"IndiceBitmap", probarIndiceBitmap},
+        {"TablaHashConcurrente (migración)", probarMigracionTablaConcurrente},
+        {"ArbolAVL", probarArbolAVL},
+        {"IndiceTiempo", probarIndiceTiempo},
+        {"AlmacenAccesos", probarAlmacenAccesos},
+        {"AlmacenAccesos (retención)", probarRetencionAccesos},
+    };
+
+    int fallas = 0;
+    for (const Prueba &p : pruebas)
+    {
+        try
+        {
+            p.ejecutar();
+            std::cout << "[Prueba] " << p.nombre << ": ok\n";
+        }
+        catch (const FallaPrueba &f)
+        {
+            ++fallas;
+            std::cout << "[Prueba] " << p.nombre << ": FALLA (" << f.detalle << ")\n";
+        }
+    }
+    int total = static_cast<int>(sizeof(pruebas) / sizeof(pruebas[0]));
+    std::cout << "[Prueba] " << total - fallas << " de " << total << " correctas\n";
+    return fallas;
+}
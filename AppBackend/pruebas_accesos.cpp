@@ -0,0 +1,190 @@
+#include "pruebas.h"
+#include "avl_tree.h"
+#include "indice_tiempo.h"
+#include "almacen_accesos.h"
+#include "registro_zonas.h"
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+// Adaptadores a una misma forma de consulta para los índices de accesos
+long contarAntes(const ArbolAVL &a, long ts) { return a.contarHasta(ts, -1); }
+long contarAntes(const IndiceTiempo &a, long ts) { return a.contarHasta(ts, -1); }
+long contarAntes(const AlmacenAccesos &a, long ts) { return a.posicionDesde(ts); }
+
+bool seleccionarEn(const ArbolAVL &a, long k, long &ts, int &zona)
+{
+    NodoAVL *n = a.seleccionar(k);
+    if (!n)
+        return false;
+    ts = n->timestamp;
+    zona = n->zonaId;
+    return true;
+}
+
+template <typename Indice>
+bool seleccionarEn(const Indice &a, long k, long &ts, int &zona)
+{
+    Acceso x;
+    if (!a.seleccionar(k, x))
+        return false;
+    ts = x.timestamp;
+    zona = x.zonaId;
+    return true;
+}
+
+typedef std::vector<std::pair<long, int>> AccesosRef; // (ts, zona)
+
+bool porTimestamp(const std::pair<long, int> &a, const std::pair<long, int> &b)
+{
+    return a.first < b.first;
+}
+
+// ref: los accesos retenidos en orden de inserción. A igual timestamp los
+// índices respetan ese orden, así que alcanza con un orden estable
+template <typename Indice>
+void compararAccesos(const Indice &indice, AccesosRef ref, const int *zonas, int numZonas,
+                     std::mt19937 &gen)
+{
+    std::stable_sort(ref.begin(), ref.end(), porTimestamp);
+    long n = static_cast<long>(ref.size());
+    comprobar(indice.getCantidad() == n, "getCantidad");
+
+    long ts;
+    int zona;
+    for (long k = 0; k < n; k += 7)
+        comprobar(seleccionarEn(indice, k, ts, zona) && ts == ref[k].first && zona == ref[k].second,
+                  "seleccionar " + std::to_string(k));
+    comprobar(!seleccionarEn(indice, n, ts, zona), "seleccionar fuera de rango");
+    if (n == 0)
+        return;
+
+    long primero = ref.front().first, ultimo = ref.back().first;
+    for (int q = 0; q < 500; ++q)
+    {
+        long inicio = primero - 100 + static_cast<long>(gen() % (ultimo - primero + 200));
+        long fin = inicio + gen() % 7200;
+        long desde = std::lower_bound(ref.begin(), ref.end(), std::make_pair(inicio, 0), porTimestamp) - ref.begin();
+        long hasta = std::upper_bound(ref.begin(), ref.end(), std::make_pair(fin, 0), porTimestamp) - ref.begin();
+        comprobar(indice.contarRango(inicio, fin) == hasta - desde, "contarRango");
+        comprobar(contarAntes(indice, inicio) == desde, "posición desde");
+
+        std::vector<long> conteo = indice.conteoZonasEnRango(inicio, fin);
+        for (int z = 0; z < numZonas; ++z)
+        {
+            long esperado = 0;
+            for (long i = desde; i < hasta; ++i)
+                esperado += ref[i].second == zonas[z];
+            long obtenido = zonas[z] < static_cast<int>(conteo.size()) ? conteo[zonas[z]] : 0;
+            comprobar(obtenido == esperado, "conteoZonasEnRango");
+        }
+
+        auto it = indice.desde(inicio, -1);
+        for (long i = desde; i < std::min(desde + 50, n); ++i, ++it)
+            comprobar(it.valido() && it->timestamp == ref[i].first && it->zonaId == ref[i].second,
+                      "recorrido desde");
+    }
+}
+
+// Accesos casi en orden, con repetidos, un 20% de rezagados de hasta 6 horas
+// y huecos de 4 horas (un rezagado puede abrir una partición en el medio)
+template <typename Indice>
+void probarIndiceAccesos(Indice &indice)
+{
+    const char *nombres[] = {"prueba-a", "prueba-b", "prueba-c", "prueba-d"};
+    int zonas[4];
+    for (int z = 0; z < 4; ++z)
+        zonas[z] = RegistroZonas::global().registrar(nombres[z]);
+    std::mt19937 gen(4);
+    AccesosRef ref;
+    long ts = 1720406400;
+    for (int i = 0; i < 30000; ++i)
+    {
+        ts += gen() % 3;
+        if (i % 5000 == 4999)
+            ts += 4 * 3600;
+        long t = gen() % 5 == 0 ? ts - static_cast<long>(gen() % 21600) : ts;
+        int z = zonas[gen() % 4];
+        indice.insertar(z, t);
+        ref.push_back({t, z});
+    }
+    compararAccesos(indice, ref, zonas, 4, gen);
+}
+
+} // namespace
+
+// Conteos, posición y selección con los tamaños de subárbol
+void probarArbolAVL()
+{
+    ArbolAVL arbol;
+    probarIndiceAccesos(arbol);
+}
+
+// Los rezagados van al árbol chico y se mezclan con el segmento ordenado;
+// las consultas por zona recorren los bloques en columnas
+void probarIndiceTiempo()
+{
+    IndiceTiempo indice;
+    probarIndiceAccesos(indice);
+}
+
+// Sin retención: selección y conteos a través de particiones de una hora
+void probarAlmacenAccesos()
+{
+    AlmacenAccesos almacen(3600, 0);
+    probarIndiceAccesos(almacen);
+}
+
+// Con retención de 5 horas: lo que admite y lo que descarta sigue la regla
+// de particiones enteras vencidas respecto del acceso más nuevo, y las
+// consultas siguen bien entre descartes
+void probarRetencionAccesos()
+{
+    const long duracion = 3600, retencion = 5 * 3600;
+    AlmacenAccesos almacen(duracion, retencion);
+    int zonas[2] = {RegistroZonas::global().registrar("prueba-a"),
+                    RegistroZonas::global().registrar("prueba-b")};
+    auto vencida = [&](long t, long maximo)
+    {
+        long inicio = t - t % duracion;
+        return maximo != LONG_MIN && inicio + duracion <= maximo - retencion;
+    };
+    std::mt19937 gen(5);
+    AccesosRef ref;
+    long maximo = LONG_MIN;
+    long ts = 1720406400;
+    for (int i = 0; i < 30000; ++i)
+    {
+        ts += gen() % 5;
+        long t = gen() % 10 == 0 ? ts - static_cast<long>(gen() % 40000) : ts;
+        int z = zonas[gen() % 2];
+        bool admitido = !vencida(t, maximo);
+        comprobar(almacen.admite(t) == admitido, "admite");
+        comprobar(almacen.insertar(z, t) == admitido, "insertar");
+        if (!admitido)
+            continue;
+        ref.push_back({t, z});
+        if (t > maximo)
+        {
+            maximo = t;
+            ref.erase(std::remove_if(ref.begin(), ref.end(),
+                                     [&](const std::pair<long, int> &a)
+                                     { return vencida(a.first, maximo); }),
+                      ref.end());
+        }
+        if (i % 5000 == 4999)
+            compararAccesos(almacen, ref, zonas, 2, gen);
+    }
+    std::set<long> inicios;
+    for (const auto &a : ref)
+        inicios.insert(a.first - a.first % duracion);
+    comprobar(almacen.getCantidadParticiones() == static_cast<int>(inicios.size()), "particiones retenidas");
+    compararAccesos(almacen, ref, zonas, 2, gen);
+}
@@ -0,0 +1,265 @@
+#include "pruebas.h"
+#include "indice_dni.h"
+#include "dary_heap.h"
+#include "max_heap.h"
+#include "cola_niveles.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+template <int D>
+void probarAridad()
+{
+    const std::string d = "D=" + std::to_string(D) + ": ";
+    std::mt19937 gen(D);
+    DaryHeap<long, D, std::greater<long>> heap(1);
+    std::multiset<long> ref;
+    auto sacarDeRef = [&ref](long v)
+    { ref.erase(ref.find(v)); };
+
+    for (int paso = 0; paso < 50000; ++paso)
+    {
+        int op = gen() % 5;
+        if (op < 2 || ref.empty())
+        {
+            long v = gen() % 1000;
+            heap.insertar(v);
+            ref.insert(v);
+        }
+        else if (op == 2)
+        {
+            comprobar(heap.extraerTope() == *ref.rbegin(), d + "extraerTope");
+            ref.erase(std::prev(ref.end()));
+        }
+        else if (op == 3)
+        {
+            // Cambia un elemento cualquiera y lo reubica
+            int i = gen() % heap.getTamanio();
+            sacarDeRef(heap.en(i));
+            long v = gen() % 1000;
+            heap.en(i) = v;
+            heap.reubicar(i);
+            ref.insert(v);
+        }
+        else
+        {
+            int i = gen() % heap.getTamanio();
+            sacarDeRef(heap.en(i));
+            heap.eliminarEn(i);
+        }
+        comprobar(heap.getTamanio() == static_cast<int>(ref.size()), d + "getTamanio");
+    }
+
+    std::vector<long> top(20);
+    int n = heap.verTopK(20, top.data());
+    comprobar(n == std::min<int>(20, ref.size()), d + "verTopK cantidad");
+    auto r = ref.rbegin();
+    for (int i = 0; i < n; ++i, ++r)
+        comprobar(top[i] == *r, d + "verTopK orden");
+
+    // Floyd sobre lo que ya había más un lote desordenado
+    for (int i = 0; i < 10000; ++i)
+    {
+        long v = gen() % 1000;
+        heap.agregarSinOrden(v);
+        ref.insert(v);
+    }
+    heap.reconstruir();
+    while (!ref.empty())
+    {
+        comprobar(heap.extraerTope() == *ref.rbegin(), d + "extraerTope tras reconstruir");
+        ref.erase(std::prev(ref.end()));
+    }
+    comprobar(heap.estaVacio(), d + "estaVacio");
+}
+
+// Los timestamps no se repiten, así el orden (prioridad, llegada) queda
+// definido del todo y los dos motores deben coincidir con la referencia
+template <typename Cola>
+void probarCola()
+{
+    std::mt19937 gen(3);
+    Cola cola;
+    std::map<long, std::pair<int, long>> enCola;      // dni -> (prioridad, ts)
+    std::set<std::tuple<int, long, long>> orden;      // (-prioridad, ts, dni)
+    std::set<long> tsUsados;
+    auto tsNuevo = [&]()
+    {
+        long ts;
+        do
+            ts = 1720406400 + gen() % 100000;
+        while (!tsUsados.insert(ts).second);
+        return ts;
+    };
+    auto agregar = [&](long dni, int prioridad, long ts)
+    {
+        enCola[dni] = {prioridad, ts};
+        orden.insert(std::make_tuple(-prioridad, ts, dni));
+    };
+    auto quitar = [&](long dni)
+    {
+        auto it = enCola.find(dni);
+        orden.erase(std::make_tuple(-it->second.first, it->second.second, dni));
+        enCola.erase(it);
+    };
+
+    // Un lote grande contra la cola vacía (en MaxHeap, camino de Floyd)
+    std::vector<Elemento> lote;
+    for (long dni = 0; dni < 2000; ++dni)
+    {
+        Elemento e = {dni, static_cast<int>(gen() % 6), tsNuevo()};
+        lote.push_back(e);
+        agregar(e.dni, e.prioridad, e.ts);
+    }
+    cola.insertarLote(lote.data(), static_cast<int>(lote.size()));
+
+    for (int paso = 0; paso < 60000; ++paso)
+    {
+        long dni = gen() % 3000;
+        bool esta = enCola.count(dni) > 0;
+        comprobar(cola.contiene(dni) == esta, "contiene");
+        switch (gen() % 8)
+        {
+        case 0:
+        case 1:
+            if (!esta)
+            {
+                int p = gen() % 6;
+                long ts = tsNuevo();
+                cola.insertar(dni, PERFILES[p], ts);
+                agregar(dni, p, ts);
+            }
+            break;
+        case 2:
+        {
+            // Lote chico: los que ya están en cola se saltean
+            lote.clear();
+            for (int i = 0; i < 5; ++i)
+            {
+                long d = gen() % 3000;
+                if (enCola.count(d))
+                    continue;
+                Elemento e = {d, static_cast<int>(gen() % 6), tsNuevo()};
+                lote.push_back(e);
+                agregar(e.dni, e.prioridad, e.ts);
+            }
+            cola.insertarLote(lote.data(), static_cast<int>(lote.size()));
+            break;
+        }
+        case 3:
+        {
+            int p = gen() % 6;
+            comprobar(cola.actualizarPrioridadDni(dni, p) == esta, "actualizarPrioridadDni");
+            if (esta)
+            {
+                long ts = enCola[dni].second;
+                quitar(dni);
+                agregar(dni, p, ts);
+            }
+            break;
+        }
+        case 4:
+            comprobar(cola.eliminarPorDni(dni) == esta, "eliminarPorDni");
+            if (esta)
+                quitar(dni);
+            break;
+        case 5:
+        case 6:
+        {
+            comprobar(cola.estaVacio() == orden.empty(), "estaVacio");
+            if (orden.empty())
+                break;
+            Elemento e = cola.extraerMax();
+            const auto &primero = *orden.begin();
+            comprobar(e.dni == std::get<2>(primero) && e.prioridad == -std::get<0>(primero) &&
+                          e.ts == std::get<1>(primero),
+                      "extraerMax");
+            quitar(e.dni);
+            break;
+        }
+        default:
+        {
+            int k = gen() % 30, n = 0;
+            Elemento *top = cola.verTopK(k, n);
+            bool igual = n == std::min<int>(k, orden.size());
+            auto it = orden.begin();
+            for (int i = 0; igual && i < n; ++i, ++it)
+                igual = top[i].dni == std::get<2>(*it) && top[i].prioridad == -std::get<0>(*it);
+            delete[] top;
+            comprobar(igual, "verTopK");
+        }
+        }
+    }
+
+    for (const auto &e : orden)
+    {
+        Elemento x = cola.extraerMax();
+        comprobar(x.dni == std::get<2>(e), "vaciar en orden");
+    }
+    comprobar(cola.estaVacio(), "estaVacio al final");
+}
+
+} // namespace
+
+void probarIndiceDni()
+{
+    std::mt19937 gen(1);
+    IndiceDni indice(4);
+    std::unordered_map<long, int> ref;
+    for (int paso = 0; paso < 200000; ++paso)
+    {
+        long dni = 10000000 + gen() % 5000;
+        switch (gen() % 3)
+        {
+        case 0:
+            indice.asignar(dni, paso);
+            ref[dni] = paso;
+            break;
+        case 1:
+            indice.eliminar(dni);
+            ref.erase(dni);
+            break;
+        default:
+        {
+            auto it = ref.find(dni);
+            comprobar(indice.obtener(dni) == (it == ref.end() ? -1 : it->second), "obtener");
+        }
+        }
+        if (paso == 100000)
+        {
+            indice.limpiar();
+            ref.clear();
+        }
+    }
+    comprobar(indice.getCantidad() == static_cast<int>(ref.size()), "getCantidad");
+    for (const auto &p : ref)
+        comprobar(indice.obtener(p.first) == p.second, "obtener al final");
+}
+
+
+void probarDaryHeap()
+{
+    probarAridad<2>();
+    probarAridad<4>();
+    probarAridad<8>();
+}
+
+void probarMaxHeap()
+{
+    probarCola<MaxHeap>();
+}
+
+void probarColaPorNiveles()
+{
+    probarCola<ColaPorNiveles>();
+}
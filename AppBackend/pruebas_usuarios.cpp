@@ -0,0 +1,282 @@
+#include "pruebas.h"
+#include "hash_table.h"
+#include "hash_table_concurrente.h"
+#include "indice_bitmap.h"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct RegistroRef
+{
+    std::string perfil;
+    EstadoUsuario estado;
+};
+
+typedef std::map<long, RegistroRef> UsuariosRef;
+
+// Operaciones al azar como las de los handlers (registro, cambio de perfil,
+// /cola y /cola/extract, validaciones), reflejadas en la referencia
+void aplicarOperaciones(TablaHashConcurrente &tabla, UsuariosRef &ref, std::mt19937 &gen, int pasos)
+{
+    for (int paso = 0; paso < pasos; ++paso)
+    {
+        long dni = 10000000 + gen() % 8000;
+        auto it = ref.find(dni);
+        bool existe = it != ref.end();
+        std::string perfil = PERFILES[1 + gen() % (NUM_PERFILES - 1)];
+        switch (gen() % 5)
+        {
+        case 0:
+            comprobar(tabla.insertar(dni, perfil) == !existe, "insertar");
+            if (!existe)
+                ref[dni] = {perfil, ESTADO_PENDIENTE};
+            break;
+        case 1:
+            comprobar(tabla.cambiarPerfil(dni, perfil) == existe, "cambiarPerfil");
+            if (existe)
+                it->second.perfil = perfil;
+            break;
+        case 2:
+            // Como /cola: solo se encola un pendiente
+            comprobar(tabla.modificar(dni, [](RegistroUsuario &r)
+                                      {
+                if (r.pendiente())
+                    r.enCola = true; }) == existe,
+                      "modificar (encolar)");
+            if (existe && it->second.estado == ESTADO_PENDIENTE)
+                it->second.estado = ESTADO_EN_COLA;
+            break;
+        case 3:
+            // Como /cola/extract
+            comprobar(tabla.modificar(dni, [](RegistroUsuario &r)
+                                      {
+                if (r.enCola) {
+                    r.enCola = false;
+                    r.atendido = true;
+                } }) == existe,
+                      "modificar (atender)");
+            if (existe && it->second.estado == ESTADO_EN_COLA)
+                it->second.estado = ESTADO_ATENDIDO;
+            break;
+        default:
+        {
+            std::string leido;
+            comprobar(tabla.validar(dni) == existe, "validar");
+            comprobar(tabla.obtenerPerfil(dni, leido) == existe && (!existe || leido == it->second.perfil),
+                      "obtenerPerfil");
+        }
+        }
+    }
+    comprobar(tabla.getCantidad() == static_cast<int>(ref.size()), "getCantidad");
+}
+
+} // namespace
+
+// El índice de pendientes de TablaHash sigue a marcarEnCola/marcarAtendido
+void probarPendientesTablaHash()
+{
+    std::mt19937 gen(7);
+    TablaHash tabla;
+    std::set<long> registrados, pendientes;
+    for (int paso = 0; paso < 50000; ++paso)
+    {
+        long dni = 10000000 + gen() % 5000;
+        if (!registrados.count(dni))
+        {
+            tabla.insertar(dni, PERFILES[gen() % NUM_PERFILES]);
+            registrados.insert(dni);
+            pendientes.insert(dni);
+            continue;
+        }
+        bool estado = gen() % 2;
+        if (gen() % 2)
+            tabla.marcarEnCola(dni, estado);
+        else
+            tabla.marcarAtendido(dni, estado);
+        if (tabla.buscar(dni)->pendiente())
+            pendientes.insert(dni);
+        else
+            pendientes.erase(dni);
+    }
+    comprobar(tabla.getCantidadPendientes() == static_cast<int>(pendientes.size()), "getCantidadPendientes");
+    std::set<long> indice;
+    for (int i = 0; i < tabla.getCantidadPendientes(); ++i)
+        indice.insert(tabla.getPendiente(i)->dni);
+    comprobar(indice == pendientes, "índice de pendientes");
+}
+
+// Los pendientes de la tabla concurrente siguen a insertar y modificar
+void probarTablaHashConcurrente()
+{
+    std::mt19937 gen(8);
+    TablaHashConcurrente tabla(4);
+    UsuariosRef ref;
+    aplicarOperaciones(tabla, ref, gen, 40000);
+
+    std::set<long> pendientes, recorridos;
+    for (const auto &r : ref)
+        if (r.second.estado == ESTADO_PENDIENTE)
+            pendientes.insert(r.first);
+    tabla.recorrerPendientes([&](const RegistroUsuario &r)
+                             { recorridos.insert(r.dni); });
+    comprobar(recorridos == pendientes, "recorrerPendientes");
+    comprobar(tabla.getCantidadPendientes() == static_cast<int>(pendientes.size()), "getCantidadPendientes");
+}
+
+// Listado paginado por cada estado, con y sin filtro de perfil: cada
+// registro sale una sola vez y coincide con la referencia
+void probarListadoTablaConcurrente()
+{
+    std::mt19937 gen(10);
+    TablaHashConcurrente tabla(4);
+    UsuariosRef ref;
+    aplicarOperaciones(tabla, ref, gen, 40000);
+
+    const std::string vip = "vip";
+    for (int e = 0; e < NUM_ESTADOS; ++e)
+    {
+        for (const std::string *perfil : {static_cast<const std::string *>(nullptr), &vip})
+        {
+            std::set<long> esperado, listado;
+            for (const auto &r : ref)
+                if (r.second.estado == e && (!perfil || r.second.perfil == *perfil))
+                    esperado.insert(r.first);
+            long desde = 0;
+            while (desde >= 0)
+            {
+                desde = tabla.listar(static_cast<EstadoUsuario>(e), perfil, static_cast<uint32_t>(desde), 37,
+                                     [&](const RegistroUsuario &r)
+                                     { comprobar(listado.insert(r.dni).second, "listar repetido"); });
+            }
+            comprobar(listado == esperado, "listar");
+        }
+    }
+}
+
+void probarIndiceBitmap()
+{
+    std::mt19937 gen(6);
+    IndiceBitmap a, b;
+    std::set<uint32_t> ra, rb;
+    // Tres contenedores: uno disperso (arreglo), uno que pasa a mapa y uno
+    // que llega a mapa y vuelve a arreglo al vaciarse en la segunda mitad
+    auto idAlAzar = [&gen]() -> uint32_t
+    {
+        switch (gen() % 3)
+        {
+        case 0:
+            return gen() % 300;
+        case 1:
+            return (1u << 16) + gen() % 9000;
+        default:
+            return (5u << 16) + gen() % 65536;
+        }
+    };
+    for (int paso = 0; paso < 200000; ++paso)
+    {
+        bool agregar = (gen() % 4 != 0) == (paso < 100000);
+        IndiceBitmap &c = gen() % 2 ? a : b;
+        std::set<uint32_t> &r = &c == &a ? ra : rb;
+        uint32_t id = idAlAzar();
+        if (agregar)
+        {
+            c.agregar(id);
+            r.insert(id);
+        }
+        else
+        {
+            c.quitar(id);
+            r.erase(id);
+        }
+        uint32_t otro = idAlAzar();
+        comprobar(c.contiene(otro) == (r.count(otro) > 0), "contiene");
+        comprobar(c.getCardinalidad() == static_cast<long>(r.size()), "getCardinalidad");
+
+        if (paso % 50000 == 49999)
+        {
+            std::vector<uint32_t> esperado;
+            std::set_intersection(ra.begin(), ra.end(), rb.begin(), rb.end(), std::back_inserter(esperado));
+            const IndiceBitmap *conjuntos[] = {&a, &b};
+            std::vector<uint32_t> obtenido, pagina;
+            long desde = 0;
+            while (desde >= 0)
+            {
+                desde = IndiceBitmap::interseccion(conjuntos, 2, static_cast<uint32_t>(desde), 97, pagina);
+                obtenido.insert(obtenido.end(), pagina.begin(), pagina.end());
+            }
+            comprobar(obtenido == esperado, "interseccion paginada");
+        }
+    }
+}
+
+// Búsquedas durante el crecimiento incremental. Con un solo fragmento hay
+// muchas migraciones: en cada inserción que deja una en curso se buscan
+// DNIs al azar (que pueden estar todavía solo en el arreglo viejo) y otros
+// que no existen. Después, lectores sin lock validan sin pausa los DNIs ya
+// insertados mientras otro hilo inserta y hace crecer la tabla
+void probarMigracionTablaConcurrente()
+{
+    std::mt19937 gen(9);
+    std::vector<long> dnis(200000);
+    for (size_t i = 0; i < dnis.size(); ++i)
+        dnis[i] = 10000000 + static_cast<long>(i);
+    std::shuffle(dnis.begin(), dnis.end(), gen);
+
+    TablaHashConcurrente tabla(1);
+    int pasosMigrando = 0;
+    for (size_t i = 0; i < dnis.size(); ++i)
+    {
+        comprobar(tabla.insertar(dnis[i], "vip"), "insertar");
+        if (!tabla.migrando())
+            continue;
+        ++pasosMigrando;
+        comprobar(!tabla.insertar(dnis[gen() % (i + 1)], "vip"), "insertar repetido durante la migración");
+        for (int j = 0; j < 8; ++j)
+        {
+            comprobar(tabla.validar(dnis[gen() % (i + 1)]), "validar durante la migración");
+            if (i + 1 < dnis.size())
+                comprobar(!tabla.validar(dnis[i + 1 + gen() % (dnis.size() - i - 1)]),
+                          "validar inexistente durante la migración");
+        }
+    }
+    comprobar(pasosMigrando > 0, "ninguna migración observada");
+    comprobar(tabla.getCantidad() == static_cast<int>(dnis.size()), "getCantidad");
+    for (long dni : dnis)
+        comprobar(tabla.validar(dni), "validar al final");
+
+    TablaHashConcurrente concurrente(2);
+    size_t mitad = dnis.size() / 2;
+    for (size_t i = 0; i < mitad; ++i)
+        concurrente.insertar(dnis[i], "vip");
+    std::atomic<bool> terminado(false);
+    std::atomic<long> fallidas(0);
+    std::vector<std::thread> lectores;
+    for (int h = 0; h < 4; ++h)
+    {
+        lectores.emplace_back([&, h]
+                              {
+            std::mt19937 g(100 + h);
+            while (!terminado.load())
+            {
+                if (!concurrente.validar(dnis[g() % mitad]))
+                    ++fallidas;
+            } });
+    }
+    for (size_t i = mitad; i < dnis.size(); ++i)
+        concurrente.insertar(dnis[i], "vip");
+    terminado.store(true);
+    for (std::thread &t : lectores)
+        t.join();
+    comprobar(fallidas.load() == 0, "validar concurrente con la tabla creciendo");
+    for (long dni : dnis)
+        comprobar(concurrente.validar(dni), "validar al final (concurrente)");
+}
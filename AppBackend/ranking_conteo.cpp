@@ -0,0 +1,35 @@
+#include "ranking_conteo.h"
+
+void RankingConteo::incrementar(int id, long cantidad)
+{
+    while (id >= getCantidad())
+    {
+        posicion.push_back(static_cast<int>(ranking.size()));
+        ranking.push_back(getCantidad()); // con conteo 0 va al final
+        conteos.push_back(0);
+    }
+    conteos[id] += cantidad;
+    reordenar(id);
+}
+
+// Inserción ordenada de un solo elemento: el id sube (o baja) intercambiándose
+// con sus vecinos. Como los conteos cambian de a poco, se mueve pocas posiciones
+void RankingConteo::reordenar(int id)
+{
+    int p = posicion[id];
+    while (p > 0 && conteos[ranking[p - 1]] < conteos[id])
+    {
+        ranking[p] = ranking[p - 1];
+        posicion[ranking[p]] = p;
+        --p;
+    }
+    int n = static_cast<int>(ranking.size());
+    while (p + 1 < n && conteos[ranking[p + 1]] > conteos[id])
+    {
+        ranking[p] = ranking[p + 1];
+        posicion[ranking[p]] = p;
+        ++p;
+    }
+    ranking[p] = id;
+    posicion[id] = p;
+}
@@ -0,0 +1,57 @@
+#include "registro_zonas.h"
+#include <mutex>
+
+RegistroZonas::RegistroZonas() : cantidad(0)
+{
+    for (int i = 0; i < MAX_ZONAS; ++i)
+        nombres[i].store(nullptr, std::memory_order_relaxed);
+}
+
+RegistroZonas::~RegistroZonas()
+{
+    int n = cantidad.load(std::memory_order_relaxed);
+    for (int i = 0; i < n; ++i)
+        delete nombres[i].load(std::memory_order_relaxed);
+}
+
+RegistroZonas &RegistroZonas::global()
+{
+    static RegistroZonas registro;
+    return registro;
+}
+
+int RegistroZonas::buscar(const std::string &zona) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return ids.buscarId(zona);
+}
+
+// Casi todas las llamadas son de zonas ya registradas: se busca primero
+// con el lock compartido y se vuelve a buscar con el exclusivo
+int RegistroZonas::registrar(const std::string &zona)
+{
+    if (zona.empty() || zona.size() > MAX_LARGO_NOMBRE)
+        return -1;
+    int id = buscar(zona);
+    if (id >= 0)
+        return id;
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    id = ids.buscarId(zona);
+    if (id >= 0)
+        return id;
+    if (ids.getCantidad() >= MAX_ZONAS)
+        return -1;
+    id = ids.internar(zona);
+    // El nombre se publica antes que la cantidad: quien ve el id ve el nombre
+    nombres[id].store(new std::string(zona), std::memory_order_release);
+    cantidad.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+const std::string &RegistroZonas::nombre(int id) const
+{
+    static const std::string vacio;
+    const std::string *n = (id >= 0 && id < MAX_ZONAS) ? nombres[id].load(std::memory_order_acquire) : nullptr;
+    return n ? *n : vacio;
+}
@@ -0,0 +1,107 @@
+#include "tabla_conteo.h"
+
+TablaConteo::TablaConteo(int tamano_inicial)
+    : tam(16)
+{
+    while (tam < tamano_inicial)
+        tam *= 2;
+    slots = new Slot[tam];
+    for (int i = 0; i < tam; ++i)
+        slots[i].id = -1;
+}
+
+TablaConteo::~TablaConteo()
+{
+    delete[] slots;
+}
+
+// FNV-1a de 32 bits
+uint32_t TablaConteo::hashFunc(const std::string &clave)
+{
+    uint32_t h = 2166136261u;
+    for (unsigned char c : clave)
+    {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+int TablaConteo::buscarId(const std::string &clave) const
+{
+    uint32_t h = hashFunc(clave);
+    int mascara = tam - 1;
+    for (int i = static_cast<int>(h) & mascara;; i = (i + 1) & mascara)
+    {
+        const Slot &s = slots[i];
+        if (s.id < 0)
+            return -1;
+        if (s.hash == h && claves[s.id] == clave)
+            return s.id;
+    }
+}
+
+int TablaConteo::internar(const std::string &clave)
+{
+    uint32_t h = hashFunc(clave);
+    int mascara = tam - 1;
+    int i = static_cast<int>(h) & mascara;
+    for (;; i = (i + 1) & mascara)
+    {
+        const Slot &s = slots[i];
+        if (s.id < 0)
+            break;
+        if (s.hash == h && claves[s.id] == clave)
+            return s.id;
+    }
+
+    int id = getCantidad();
+    claves.push_back(clave);
+    conteos.incrementar(id, 0); // con conteo 0 va al final del ranking
+    slots[i].hash = h;
+    slots[i].id = id;
+
+    // Factor de carga máximo 1/2: las claves suelen ser pocas (zonas)
+    if (2 * getCantidad() > tam)
+        rehash();
+    return id;
+}
+
+// Duplica la tabla; las claves y contadores no se mueven, solo los slots
+void TablaConteo::rehash()
+{
+    Slot *viejos = slots;
+    int viejoTam = tam;
+    tam *= 2;
+    slots = new Slot[tam];
+    for (int i = 0; i < tam; ++i)
+        slots[i].id = -1;
+
+    int mascara = tam - 1;
+    for (int j = 0; j < viejoTam; ++j)
+    {
+        if (viejos[j].id < 0)
+            continue;
+        int i = static_cast<int>(viejos[j].hash) & mascara;
+        while (slots[i].id >= 0)
+            i = (i + 1) & mascara;
+        slots[i] = viejos[j];
+    }
+    delete[] viejos;
+}
+
+void TablaConteo::incrementar(const std::string &clave, long cantidad)
+{
+    incrementarId(internar(clave), cantidad);
+}
+
+void TablaConteo::incrementarId(int id, long cantidad)
+{
+    conteos.incrementar(id, cantidad);
+}
+
+long TablaConteo::obtenerConteo(const std::string &clave) const
+{
+    int id = buscarId(clave);
+    return id < 0 ? 0 : conteos.getConteo(id);
+}
@@ -31,6 +31,8 @@ export default function AccessLogForm() {
                 setMsg('Acceso registrado correctamente')
                 setZona('')
                 setTs('')
+            } else if (res.status === 422) {
+                setMsg('La fecha es anterior al período de retención de accesos')
             } else {
                 setMsg('Error al registrar acceso')
             }
@@ -1,5 +1,5 @@
 import { useState } from 'react'
-import { getAccesosRango } from '../api/cliente'
+import { getAccesosRangoOffset } from '../api/cliente'
 import './TimeRangeReport.css'
 
 function mostrarZona(zona) {
@@ -17,7 +17,33 @@ export default function TimeRangeReport() {
     const [msg, setMsg] = useState(null)
     const [loading, setLoading] = useState(false)
     const [pagina, setPagina] = useState(0)
+    const [rango, setRango] = useState(null)
+    const [total, setTotal] = useState(0)
     const porPagina = 20
+    const totalPaginas = Math.ceil(total / porPagina)
+
+    // El servidor devuelve solo la página pedida y cuántos accesos hay en
+    // el rango, así se puede saltar a cualquier página por offset
+    const cargarPagina = async (ini, fin, p) => {
+        setLoading(true)
+        try {
+            const data = await getAccesosRangoOffset(ini, fin, porPagina, p * porPagina)
+            setResult(data.accesos)
+            setTotal(data.total)
+            setPagina(p)
+        } catch {
+            setMsg('Error al consultar accesos')
+        }
+        setLoading(false)
+    }
+
+    const irSiguiente = () => {
+        cargarPagina(rango.ini, rango.fin, pagina + 1)
+    }
+
+    const irAnterior = () => {
+        cargarPagina(rango.ini, rango.fin, pagina - 1)
+    }
 
     const handleSubmit = async (e) => {
         e.preventDefault()
@@ -33,14 +59,8 @@ export default function TimeRangeReport() {
             setMsg('Formato de fecha inválido')
             return
         }
-        setLoading(true)
-        try {
-            const data = await getAccesosRango(iniTs, finTs)
-            setResult(data)
-        } catch {
-            setMsg('Error al consultar accesos')
-        }
-        setLoading(false)
+        setRango({ ini: iniTs, fin: finTs })
+        await cargarPagina(iniTs, finTs, 0)
     }
 
     return (
@@ -67,9 +87,9 @@ export default function TimeRangeReport() {
             {msg && <div className="time-range-msg">{msg}</div>}
             {result.length > 0 && (
                 <div className="time-range-result">
-                    <h4>Accesos en rango:</h4>
+                    <h4>Accesos en rango: {total}</h4>
                     <ul>
-                        {result.slice(pagina * porPagina, (pagina + 1) * porPagina).map((a, i) => (
+                        {result.map((a, i) => (
                             <li key={pagina * porPagina + i}>
                                 Zona: <b>{mostrarZona(a.zona)}</b> | Fecha: {new Date(a.ts * 1000).toLocaleString()}
                             </li>
@@ -77,15 +97,15 @@ export default function TimeRangeReport() {
                     </ul>
                     <div style={{ textAlign: 'center', marginTop: '1rem' }}>
                         <button
-                            onClick={() => setPagina(p => Math.max(0, p - 1))}
-                            disabled={pagina === 0}
+                            onClick={irAnterior}
+                            disabled={pagina === 0 || loading}
                         >Anterior</button>
                         <span style={{ margin: '0 1rem' }}>
-                            Página {pagina + 1} de {Math.ceil(result.length / porPagina)}
+                            Página {pagina + 1} de {totalPaginas}
                         </span>
                         <button
-                            onClick={() => setPagina(p => p + 1)}
-                            disabled={(pagina + 1) * porPagina >= result.length}
+                            onClick={irSiguiente}
+                            disabled={pagina + 1 >= totalPaginas || loading}
                         >Siguiente</button>
                     </div>
                 </div>
@@ -6,13 +6,22 @@ export default function TopZoneReport() {
     const [zona, setZona] = useState(null)
     const [loading, setLoading] = useState(false)
     const [msg, setMsg] = useState(null)
+    const [ventana, setVentana] = useState(null)
 
-    const handleClick = async () => {
+    // minutos = null consulta todo el historial
+    const consultar = async (minutos) => {
         setLoading(true)
         setMsg(null)
         try {
-            const z = await getZonaTop()
-            setZona(z)
+            let z
+            if (minutos) {
+                const ahora = Math.floor(Date.now() / 1000)
+                z = await getZonaTop(ahora - minutos * 60, ahora)
+            } else {
+                z = await getZonaTop()
+            }
+            setZona(z || '-')
+            setVentana(minutos)
         } catch {
             setMsg('Error al consultar zona top')
         }
@@ -21,10 +30,17 @@ export default function TopZoneReport() {
 
     return (
         <div className="top-zone-report">
-            <button onClick={handleClick} disabled={loading}>
+            <button onClick={() => consultar(null)} disabled={loading}>
                 Mostrar Zona Top
             </button>
-            {zona && <div className="top-zone-result">Zona con más accesos: <b>{zona}</b></div>}
+            <button onClick={() => consultar(15)} disabled={loading}>
+                Últimos 15 minutos
+            </button>
+            {zona && (
+                <div className="top-zone-result">
+                    Zona con más accesos{ventana ? ` (últimos ${ventana} min)` : ''}: <b>{zona}</b>
+                </div>
+            )}
             {msg && <div className="top-zone-msg">{msg}</div>}
         </div>
     )
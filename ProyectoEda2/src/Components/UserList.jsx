@@ -1,5 +1,5 @@
 import { useEffect, useState } from 'react'
-import { getUsuarios, encolarUsuario, actualizarPerfil, actualizarPrioridadCola, buscarUsuario } from '../api/cliente'
+import { getUsuariosFiltrados, encolarUsuario, actualizarPerfil, actualizarPrioridadCola, buscarUsuario } from '../api/cliente'
 import './UserList.css'
 
 const perfiles = [
@@ -80,18 +80,41 @@ export default function UserList({ onQueueRefresh, editable = true }) {
     const [loading, setLoading] = useState(true)
     const [editUser, setEditUser] = useState(null)
     const [msg, setMsg] = useState(null)
+    const [filtroPerfil, setFiltroPerfil] = useState('')
+    // Cursor con el que empieza cada página visitada (la primera sin
+    // cursor), para poder volver atrás; siguiente es el que dio el servidor
+    const [cursores, setCursores] = useState([null])
+    const [siguiente, setSiguiente] = useState(null)
+    const porPagina = 50
 
-    const fetchUsuarios = () => {
+    // El servidor filtra los pendientes y devuelve solo una página
+    const cargarPagina = async (pilaCursores) => {
         setLoading(true)
-        getUsuarios().then(data => {
-            setUsuarios(data)
-            setLoading(false)
-        })
+        try {
+            const data = await getUsuariosFiltrados({
+                perfil: filtroPerfil || undefined,
+                limit: porPagina,
+                cursor: pilaCursores[pilaCursores.length - 1]
+            })
+            setUsuarios(data.usuarios)
+            setSiguiente(data.cursor)
+            setCursores(pilaCursores)
+        } catch {
+            setMsg('Error al cargar usuarios')
+        }
+        setLoading(false)
     }
 
+    // Recarga la página actual (por ejemplo tras encolar o editar)
+    const fetchUsuarios = () => cargarPagina(cursores)
+
+    const irSiguiente = () => cargarPagina([...cursores, siguiente])
+
+    const irAnterior = () => cargarPagina(cursores.slice(0, -1))
+
     useEffect(() => {
-        fetchUsuarios()
-    }, [])
+        cargarPagina([null])
+    }, [filtroPerfil])
 
     const handleEncolar = async (u) => {
         setMsg(null)
@@ -115,6 +138,13 @@ export default function UserList({ onQueueRefresh, editable = true }) {
     return (
         <div className="user-list">
             <h3>Usuarios no atendidos</h3>
+            <label>
+                Perfil:{' '}
+                <select value={filtroPerfil} onChange={e => setFiltroPerfil(e.target.value)}>
+                    <option value="">Todos</option>
+                    {perfiles.map(p => <option key={p.value} value={p.value}>{p.label}</option>)}
+                </select>
+            </label>
             {msg && (
                 <div
                     className={
@@ -152,6 +182,19 @@ export default function UserList({ onQueueRefresh, editable = true }) {
                     </tbody>
                 </table>
             )}
+            <div style={{ textAlign: 'center', marginTop: '1rem' }}>
+                <button
+                    onClick={irAnterior}
+                    disabled={cursores.length === 1 || loading}
+                >Anterior</button>
+                <span style={{ margin: '0 1rem' }}>
+                    Página {cursores.length}
+                </span>
+                <button
+                    onClick={irSiguiente}
+                    disabled={!siguiente || loading}
+                >Siguiente</button>
+            </div>
             {editable && editUser &&
                 <EditProfileModal
                     usuario={editUser}
@@ -1,8 +1,13 @@
 const BASE_URL = "http://localhost:18080";
 
 // ----------- Usuarios (Hash Table) -----------
-export async function getUsuarios() {
-    const res = await fetch(`${BASE_URL}/usuarios`);
+// Página filtrada en el servidor: { usuarios, cursor }. Pasar el cursor
+// recibido para pedir la página siguiente (null cuando no hay más)
+export async function getUsuariosFiltrados({ perfil, estado = "pendiente", limit = 50, cursor } = {}) {
+    const params = new URLSearchParams({ estado, limit });
+    if (perfil) params.set("perfil", perfil);
+    if (cursor) params.set("cursor", cursor);
+    const res = await fetch(`${BASE_URL}/usuarios?${params}`);
     return res.json();
 }
 
@@ -70,12 +75,17 @@ export async function registrarAcceso(zona, ts) {
     return res;
 }
 
-export async function getAccesosRango(inicio, fin) {
-    const res = await fetch(`${BASE_URL}/accesos/rango?inicio=${inicio}&fin=${fin}`);
+export async function getAccesosRangoOffset(inicio, fin, limit, offset) {
+    const params = new URLSearchParams({ inicio, fin, limit, offset });
+    const res = await fetch(`${BASE_URL}/accesos/rango?${params}`);
     return res.json();
 }
 
-export async function getZonaTop() {
-    const res = await fetch(`${BASE_URL}/accesos/zona_top`);
+// Sin argumentos, la zona top de todo el historial; con inicio y fin, la
+// de esa ventana de tiempo
+export async function getZonaTop(inicio, fin) {
+    const ventana = inicio !== undefined ? `?${new URLSearchParams({ inicio, fin })}` : "";
+    const res = await fetch(`${BASE_URL}/accesos/zona_top${ventana}`);
     return res.text();
 }
+